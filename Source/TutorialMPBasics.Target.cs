@@ -10,5 +10,9 @@ public class TutorialMPBasicsTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		ExtraModuleNames.AddRange( new string[] { "TutorialMPBasics" } );
+
+		// No target-level switches for push model (`bWithPushModel`) or Iris (`bUseIris`): both require a unique build
+		// environment, which an installed engine (cf. "launch.bat") doesn't allow. Push model is switched on at runtime
+		// via `net.IsPushModelEnabled` in "DefaultEngine.ini"; `MARK_PROPERTY_DIRTY_FROM_NAME` compiles either way.
 	}
 }
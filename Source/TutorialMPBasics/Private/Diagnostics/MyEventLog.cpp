@@ -0,0 +1,364 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Diagnostics/MyEventLog.h"
+
+#include "Diagnostics/MyMemoryTags.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMyEvents, Log, All);
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarEventLog
+		( TEXT("mp.EventLog")
+		, true
+		, TEXT("Record diagnostic events into the binary event log")
+		);
+
+	TAutoConsoleVariable<float> CVarEventLogFlushInterval
+		( TEXT("mp.EventLog.FlushInterval")
+		, 0.5f
+		, TEXT("Seconds between two writes of the event log to disk")
+		);
+
+	TAutoConsoleVariable<bool> CVarEventLogEcho
+		( TEXT("mp.EventLog.Echo")
+		, false
+		, TEXT("Also print every event to the regular log, formatted by the flush thread")
+		);
+
+	FAutoConsoleCommand EventLogFlushCommand
+		( TEXT("mp.EventLog.Flush")
+		, TEXT("Write the event log to disk now")
+		, FConsoleCommandDelegate::CreateLambda([] ()
+		{
+			FMyEventLog::Get().Flush();
+		})
+		);
+
+	// file format, all little endian, cf. "decode_events.py"
+	constexpr uint32 FileMagic = 0x5645504D; // "MPEV"
+	constexpr uint32 FileVersion = 1;
+	enum class EBlock : uint8
+	{
+		Event = 1,
+		Name = 2,
+		Dropped = 3,
+	};
+
+	const TCHAR* EventNames[] =
+	{
+#define MP_EVENT_NAME(Name, Format) TEXT(#Name),
+		MP_EVENT_LIST(MP_EVENT_NAME)
+#undef MP_EVENT_NAME
+	};
+
+	const TCHAR* EventFormats[] =
+	{
+#define MP_EVENT_FORMAT(Name, Format) TEXT(Format),
+		MP_EVENT_LIST(MP_EVENT_FORMAT)
+#undef MP_EVENT_FORMAT
+	};
+
+	// the ring of the calling thread, created with its first event
+	thread_local void* ThreadRing = nullptr;
+
+	template<typename T>
+	void Append(TArray<uint8>& Buffer, const T& Value)
+	{
+		Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	void AppendString(TArray<uint8>& Buffer, const FString& String)
+	{
+		const FTCHARToUTF8 Utf8(*String);
+		Append(Buffer, static_cast<uint16>(Utf8.Length()));
+		Buffer.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	FString NameToString(uint32 DisplayIndex, uint32 Number)
+	{
+		return FName::CreateFromDisplayId(FNameEntryId::FromUnstableInt(DisplayIndex), Number).ToString();
+	}
+}
+
+class FFlushRunnable : public FRunnable
+{
+public:
+	explicit FFlushRunnable(FMyEventLog& InLog)
+		: Log(InLog)
+	{
+	}
+
+	virtual uint32 Run() override
+	{
+		Log.FlushThreadMain();
+		return 0;
+	}
+
+private:
+	FMyEventLog& Log;
+};
+
+FMyEventLog& FMyEventLog::Get()
+{
+	static FMyEventLog EventLog;
+	return EventLog;
+}
+
+const TCHAR* FMyEventLog::GetEventFormat(EMyEvent Event)
+{
+	return EventFormats[static_cast<int32>(Event)];
+}
+
+void FMyEventLog::Start()
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Diagnostics);
+	check(IsInGameThread());
+	if(bRunning)
+	{
+		return;
+	}
+	const FString FileName = FPaths::ProjectLogDir() / FString::Printf(TEXT("Events-%s.mpev"), *FDateTime::Now().ToString());
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::ProjectLogDir());
+	File.Reset(PlatformFile.OpenWrite(*FileName));
+	if(!File.IsValid())
+	{
+		UE_LOG(LogMyEvents, Error, TEXT("couldn't open event log %s"), *FileName)
+		return;
+	}
+
+	// header: everything the decoder needs to turn the file into text, independent of the build that wrote it
+	StartCycles = FPlatformTime::Cycles64();
+	Buffer.Reset();
+	Append(Buffer, FileMagic);
+	Append(Buffer, FileVersion);
+	Append(Buffer, FPlatformTime::GetSecondsPerCycle64());
+	Append(Buffer, StartCycles);
+	Append(Buffer, static_cast<uint16>(EMyEvent::Num));
+	for(int32 i = 0; i < static_cast<int32>(EMyEvent::Num); ++i)
+	{
+		AppendString(Buffer, EventNames[i]);
+		AppendString(Buffer, EventFormats[i]);
+	}
+	File->Write(Buffer.GetData(), Buffer.Num());
+	Buffer.Reset();
+	WrittenNames.Reset();
+
+	bEnabled = CVarEventLog.GetValueOnGameThread();
+	CVarEventLog->SetOnChangedCallback(FConsoleVariableDelegate::CreateLambda([this] (IConsoleVariable* Variable)
+	{
+		bEnabled = Variable->GetBool();
+	}));
+
+	WakeUp = FPlatformProcess::GetSynchEventFromPool();
+	Runnable = new FFlushRunnable(*this);
+	bRunning = true;
+	Thread = FRunnableThread::Create(Runnable, TEXT("MyEventLogFlush"), 0, TPri_BelowNormal);
+	UE_LOG(LogMyEvents, Display, TEXT("event log: %s"), *FileName)
+}
+
+void FMyEventLog::Stop()
+{
+	check(IsInGameThread());
+	if(!bRunning)
+	{
+		return;
+	}
+	bRunning = false;
+	WakeUp->Trigger();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+	delete Runnable;
+	Runnable = nullptr;
+	FPlatformProcess::ReturnSynchEventToPool(WakeUp);
+	WakeUp = nullptr;
+
+	// whatever got recorded meanwhile
+	Drain();
+	FScopeLock Lock(&DrainLock);
+	File.Reset();
+	CVarEventLog->SetOnChangedCallback(FConsoleVariableDelegate());
+}
+
+void FMyEventLog::Flush()
+{
+	if(bRunning)
+	{
+		Drain();
+		FScopeLock Lock(&DrainLock);
+		File->Flush();
+	}
+}
+
+FMyEventLog::FRing& FMyEventLog::GetThreadRing()
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Diagnostics);
+	if(ThreadRing == nullptr)
+	{
+		// once per thread
+		TUniquePtr<FRing> Ring = MakeUnique<FRing>();
+		Ring->ThreadId = FPlatformTLS::GetCurrentThreadId();
+		ThreadRing = Ring.Get();
+		FScopeLock Lock(&RingsLock);
+		Rings.Add(MoveTemp(Ring));
+	}
+	return *static_cast<FRing*>(ThreadRing);
+}
+
+FMyEventLog::FRecord* FMyEventLog::BeginRecord()
+{
+	FRing& Ring = GetThreadRing();
+	const uint32 Head = Ring.Head.load(std::memory_order_relaxed);
+	if(Head - Ring.Tail.load(std::memory_order_acquire) >= FRing::Capacity)
+	{
+		Ring.Dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	return &Ring.Records[Head % FRing::Capacity];
+}
+
+void FMyEventLog::EndRecord()
+{
+	FRing& Ring = *static_cast<FRing*>(ThreadRing);
+	// publishes the record to the flush thread
+	Ring.Head.store(Ring.Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void FMyEventLog::FlushThreadMain()
+{
+	while(bRunning)
+	{
+		WakeUp->Wait(FTimespan::FromSeconds(FMath::Max(CVarEventLogFlushInterval.GetValueOnAnyThread(), 0.01f)));
+		Drain();
+	}
+}
+
+void FMyEventLog::Drain()
+{
+	FScopeLock Lock(&DrainLock);
+	if(!File.IsValid())
+	{
+		return;
+	}
+	TArray<FRing*, TInlineAllocator<16>> RingsToDrain;
+	{
+		FScopeLock RingsScopeLock(&RingsLock);
+		for(const TUniquePtr<FRing>& Ring : Rings)
+		{
+			RingsToDrain.Add(Ring.Get());
+		}
+	}
+	const bool bEcho = CVarEventLogEcho.GetValueOnAnyThread();
+	for(FRing* Ring : RingsToDrain)
+	{
+		const uint32 Head = Ring->Head.load(std::memory_order_acquire);
+		uint32 Tail = Ring->Tail.load(std::memory_order_relaxed);
+		for(; Tail != Head; ++Tail)
+		{
+			const FRecord& Record = Ring->Records[Tail % FRing::Capacity];
+			WriteRecord(Record, Ring->ThreadId);
+			if(bEcho)
+			{
+				UE_LOG(LogMyEvents, Display, TEXT("%s"), *FormatRecord(Record))
+			}
+		}
+		// hands the slots back to the producer
+		Ring->Tail.store(Tail, std::memory_order_release);
+
+		if(const uint32 Dropped = Ring->Dropped.exchange(0, std::memory_order_relaxed))
+		{
+			Append(Buffer, EBlock::Dropped);
+			Append(Buffer, Ring->ThreadId);
+			Append(Buffer, Dropped);
+		}
+	}
+	if(Buffer.Num() > 0)
+	{
+		File->Write(Buffer.GetData(), Buffer.Num());
+		Buffer.Reset();
+	}
+}
+
+void FMyEventLog::WriteRecord(const FRecord& Record, uint32 ThreadId)
+{
+	// names go into the file once, before their first use
+	if(Record.ObjectName != 0)
+	{
+		WriteName(Record.ObjectName);
+	}
+	for(int32 i = 0; i < Record.NumArgs; ++i)
+	{
+		if(Record.ArgTypes[i] == EArgType::Name)
+		{
+			WriteName(static_cast<uint32>(Record.Args[i]));
+		}
+	}
+
+	Append(Buffer, EBlock::Event);
+	Append(Buffer, Record.Event);
+	Append(Buffer, ThreadId);
+	Append(Buffer, Record.Cycles);
+	Append(Buffer, Record.ObjectId);
+	Append(Buffer, Record.ObjectName);
+	Append(Buffer, Record.ObjectNameNumber);
+	Append(Buffer, Record.NumArgs);
+	for(int32 i = 0; i < Record.NumArgs; ++i)
+	{
+		Append(Buffer, Record.ArgTypes[i]);
+		Append(Buffer, Record.Args[i]);
+	}
+}
+
+void FMyEventLog::WriteName(uint32 DisplayIndex)
+{
+	bool bAlreadyWritten;
+	WrittenNames.Add(DisplayIndex, &bAlreadyWritten);
+	if(!bAlreadyWritten)
+	{
+		Append(Buffer, EBlock::Name);
+		Append(Buffer, DisplayIndex);
+		AppendString(Buffer, NameToString(DisplayIndex, 0));
+	}
+}
+
+FString FMyEventLog::FormatRecord(const FRecord& Record) const
+{
+	FString Text = GetEventFormat(Record.Event);
+	for(int32 i = 0; i < Record.NumArgs; ++i)
+	{
+		FString Arg;
+		switch(Record.ArgTypes[i])
+		{
+		case EArgType::Int:
+			Arg = LexToString(static_cast<int64>(Record.Args[i]));
+			break;
+		case EArgType::Float:
+			{
+				double Double;
+				FMemory::Memcpy(&Double, &Record.Args[i], sizeof(Double));
+				Arg = FString::SanitizeFloat(Double);
+			}
+			break;
+		case EArgType::Bool:
+			Arg = Record.Args[i] ? TEXT("true") : TEXT("false");
+			break;
+		case EArgType::Name:
+			Arg = NameToString(static_cast<uint32>(Record.Args[i]), static_cast<uint32>(Record.Args[i] >> 32));
+			break;
+		}
+		Text.ReplaceInline(*FString::Printf(TEXT("{%d}"), i), *Arg);
+	}
+	return FString::Printf
+		( TEXT("%s#%u: %s")
+		, Record.ObjectName != 0 ? *NameToString(Record.ObjectName, Record.ObjectNameNumber) : TEXT("-")
+		, Record.ObjectId
+		, *Text
+		);
+}
@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Diagnostics/MyMemoryReport.h"
+
+#include "Diagnostics/MyMemoryTags.h"
+#include "Engine/LocalPlayer.h"
+#include "Modes/MyGISubsystem.h"
+#include "Modes/MyLocalPlayer.h"
+
+LLM_DEFINE_TAG(TutorialMPBasics);
+LLM_DEFINE_TAG(TutorialMPBasics_Sessions);
+LLM_DEFINE_TAG(TutorialMPBasics_Online);
+LLM_DEFINE_TAG(TutorialMPBasics_Pawns);
+LLM_DEFINE_TAG(TutorialMPBasics_Lockstep);
+LLM_DEFINE_TAG(TutorialMPBasics_HUD);
+LLM_DEFINE_TAG(TutorialMPBasics_Diagnostics);
+
+namespace
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	// the tags in the report, cf. `FPhaseStats::Tags`
+	FName GetTagName(int32 Index)
+	{
+		const FName Names[] =
+		{
+			LLM_TAGNAME(TutorialMPBasics),
+			LLM_TAGNAME(TutorialMPBasics_Sessions),
+			LLM_TAGNAME(TutorialMPBasics_Online),
+			LLM_TAGNAME(TutorialMPBasics_Pawns),
+			LLM_TAGNAME(TutorialMPBasics_Lockstep),
+			LLM_TAGNAME(TutorialMPBasics_HUD),
+			LLM_TAGNAME(TutorialMPBasics_Diagnostics),
+		};
+		return Names[Index];
+	}
+	constexpr int32 NumTags = 7;
+#else
+	FName GetTagName(int32 Index)
+	{
+		return NAME_None;
+	}
+	constexpr int32 NumTags = 0;
+#endif
+
+	bool IsTrackingTags()
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		return FLowLevelMemTracker::IsEnabled();
+#else
+		return false;
+#endif
+	}
+
+	float ToMB(int64 Bytes)
+	{
+		return Bytes / (1024.f * 1024.f);
+	}
+
+	FAutoConsoleCommandWithWorld MemReportCommand
+		( TEXT("mp.MemReport")
+		, TEXT("Log current and peak memory per session phase (menu, searching, in level), per module system with -LLM")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(const UMyMemoryReport* MemoryReport = World && World->GetGameInstance() ? World->GetGameInstance()->GetSubsystem<UMyMemoryReport>() : nullptr)
+			{
+				MemoryReport->LogReport();
+			}
+		})
+		);
+}
+
+void UMyMemoryReport::LogReport() const
+{
+	if(!IsTrackingTags())
+	{
+		UE_LOG(LogTemp, Display, TEXT("MemReport: start with -LLM for numbers per system"))
+	}
+	for(int32 i = 0; i < static_cast<int32>(EMemoryPhase::Num); ++i)
+	{
+		const EMemoryPhase Phase = static_cast<EMemoryPhase>(i);
+		const FPhaseStats& Stats = Phases[i];
+		const FMemoryPhaseBudget* Budget = Budgets.FindByPredicate([Phase] (const FMemoryPhaseBudget& B)
+		{
+			return B.Phase == Phase;
+		});
+		UE_LOG
+			( LogTemp
+			, Display
+			, TEXT("MemReport: %-10s %5d samples, current %8.1f MB, peak %8.1f MB, budget %s")
+			, *UEnum::GetDisplayValueAsText(Phase).ToString()
+			, Stats.Samples
+			, ToMB(Stats.Process.Current)
+			, ToMB(Stats.Process.Peak)
+			, Budget ? *FString::Printf(TEXT("%.0f MB%s"), Budget->MB, ToMB(Stats.Process.Peak) > Budget->MB ? TEXT(" EXCEEDED") : TEXT("")) : TEXT("-")
+			)
+		for(int32 Tag = 0; Tag < Stats.Tags.Num(); ++Tag)
+		{
+			UE_LOG
+				( LogTemp
+				, Display
+				, TEXT("MemReport: %-10s   %-30s current %8.2f MB, peak %8.2f MB")
+				, *UEnum::GetDisplayValueAsText(Phase).ToString()
+				, *GetTagName(Tag).ToString()
+				, ToMB(Stats.Tags[Tag].Current)
+				, ToMB(Stats.Tags[Tag].Peak)
+				)
+		}
+	}
+}
+
+void UMyMemoryReport::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// the phase depends on the session stage
+	Collection.InitializeDependency<UMyGISubsystem>();
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMyMemoryReport::Tick));
+}
+
+void UMyMemoryReport::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	if(FParse::Param(FCommandLine::Get(), TEXT("MemReportOnExit")))
+	{
+		LogReport();
+	}
+	Super::Deinitialize();
+}
+
+bool UMyMemoryReport::Tick(float DeltaTime)
+{
+	SinceSample += DeltaTime;
+	if(SinceSample >= SampleInterval)
+	{
+		SinceSample = 0.f;
+		Sample();
+	}
+	return true;
+}
+
+EMemoryPhase UMyMemoryReport::GetPhase() const
+{
+	switch(GetGameInstance()->GetSubsystem<UMyGISubsystem>()->GetSessionStage())
+	{
+	case ESessionStage::Searching:
+	case ESessionStage::Found:
+	case ESessionStage::Joining:
+		return EMemoryPhase::Searching;
+	default:
+		break;
+	}
+	const UMyLocalPlayer* LocalPlayer = Cast<UMyLocalPlayer>(GetGameInstance()->GetFirstGamePlayer());
+	// no local player: dedicated server
+	return LocalPlayer && LocalPlayer->CurrentLevel == ECurrentLevel::MainMenu ? EMemoryPhase::Menu : EMemoryPhase::InLevel;
+}
+
+void UMyMemoryReport::Sample()
+{
+	const EMemoryPhase Phase = GetPhase();
+	if(Phase != LastPhase)
+	{
+		LastPhase = Phase;
+		bBudgetWarned = false;
+	}
+	FPhaseStats& Stats = Phases[static_cast<int32>(Phase)];
+	++Stats.Samples;
+	Stats.Process.Add(FPlatformMemory::GetStats().UsedPhysical);
+
+	if(IsTrackingTags())
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		Stats.Tags.SetNum(NumTags);
+		for(int32 Tag = 0; Tag < NumTags; ++Tag)
+		{
+			Stats.Tags[Tag].Add(FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, GetTagName(Tag), false));
+		}
+#endif
+	}
+
+	const FMemoryPhaseBudget* Budget = Budgets.FindByPredicate([Phase] (const FMemoryPhaseBudget& B)
+	{
+		return B.Phase == Phase;
+	});
+	if(Budget && !bBudgetWarned && ToMB(Stats.Process.Current) > Budget->MB)
+	{
+		bBudgetWarned = true;
+		UE_LOG
+			( LogTemp
+			, Warning
+			, TEXT("%s: %.1f MB used (%s), over the budget of %.0f MB")
+			, *GetFullName()
+			, ToMB(Stats.Process.Current)
+			, *UEnum::GetDisplayValueAsText(Phase).ToString()
+			, Budget->MB
+			)
+	}
+}
@@ -3,22 +3,31 @@
 
 #include "HUD/MyHUD.h"
 
+#include "Diagnostics/MyEventLog.h"
+#include "Diagnostics/MyMemoryTags.h"
 #include "Blueprint/UserWidget.h"
+#include "Engine/GameViewportClient.h"
 #include "HUD/UW_HUD.h"
 
 #define LOCTEXT_NAMESPACE "HUD"
 
 void AMyHUD::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(TutorialMPBasics_HUD);
 	Super::BeginPlay();
 
 	if(!IsValid(UW_HUD_Class))
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s: UW_HUD_Class null"), *GetFullName())
+		MP_EVENT(HUDClassMissing, this, FName(TEXT("UW_HUD_Class")));
 		return;
 	}
-	UW_HUD = CreateWidget<UUW_HUD>(GetGameInstance(), UW_HUD_Class, FName(TEXT("HUD")));
-	UW_HUD->AddToViewport();
+	// split screen: every local player gets their own HUD, in their part of the screen
+	if(UGameViewportClient* Viewport = GetWorld()->GetGameViewport())
+	{
+		Viewport->SetForceDisableSplitscreen(false);
+	}
+	UW_HUD = CreateWidget<UUW_HUD>(GetOwningPlayerController(), UW_HUD_Class, FName(TEXT("HUD")));
+	UW_HUD->AddToPlayerScreen();
 
 	// `AHUD::GetLocalRole()` is always `ROLE_Authority` as the local player apparently has authority over their HUD,
 	// whereas the `GetOwningPlayerController()` allows us to distinguish between host and client.
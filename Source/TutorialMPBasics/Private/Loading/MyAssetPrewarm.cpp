@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Loading/MyAssetPrewarm.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Modes/MyLocalPlayer.h"
+
+namespace
+{
+	const FPrimaryAssetType PrewarmAssetType(TEXT("Prewarm"));
+	const FName PrewarmBundleName(TEXT("Game"));
+
+	FAutoConsoleCommandWithWorldAndArgs PrewarmCommand
+		( TEXT("mp.Prewarm")
+		, TEXT("mp.Prewarm [start|cancel]: log asset pre-warming and level load stalls, or start/cancel pre-warming")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			UMyAssetPrewarm* Prewarm = World && World->GetGameInstance() ? World->GetGameInstance()->GetSubsystem<UMyAssetPrewarm>() : nullptr;
+			if(!Prewarm)
+			{
+				return;
+			}
+			if(Args.IsEmpty())
+			{
+				Prewarm->LogReport();
+			}
+			else if(Args[0] == TEXT("start"))
+			{
+				Prewarm->StartPrewarm();
+			}
+			else if(Args[0] == TEXT("cancel"))
+			{
+				Prewarm->CancelPrewarm();
+			}
+		})
+		);
+}
+
+void UMyAssetPrewarm::StartPrewarm()
+{
+	if(bStarted)
+	{
+		return;
+	}
+	bStarted = true;
+	StartCountdown = -1.f;
+	UAssetManager& AssetManager = UAssetManager::Get();
+	for(const FPrewarmBundle& Bundle : Bundles)
+	{
+		// a primary asset that exists at runtime only, consisting of one bundle with the configured assets
+		const FPrimaryAssetId AssetId(PrewarmAssetType, Bundle.Name);
+		FAssetBundleData BundleData;
+		BundleData.AddBundleAssets(PrewarmBundleName, Bundle.Assets);
+		AssetManager.AddDynamicAsset(AssetId, FSoftObjectPath(), BundleData);
+
+		const int32 Index = States.Num();
+		FBundleState& State = States.AddDefaulted_GetRef();
+		State.Name = Bundle.Name;
+		State.StartTime = FPlatformTime::Seconds();
+		State.Handle = AssetManager.LoadPrimaryAsset
+			( AssetId
+			, {PrewarmBundleName}
+			, FStreamableDelegate::CreateWeakLambda(this, [this, Index] ()
+			{
+				States[Index].LoadSeconds = FPlatformTime::Seconds() - States[Index].StartTime;
+			})
+			, Bundle.Priority
+			);
+		// nothing to load (anymore): no handle, or one that completed right away
+		if(!State.Handle.IsValid())
+		{
+			State.LoadSeconds = 0.;
+		}
+	}
+	UE_LOG(LogTemp, Display, TEXT("%s: pre-warming %d bundles"), *GetFullName(), Bundles.Num())
+}
+
+void UMyAssetPrewarm::CancelPrewarm()
+{
+	StartCountdown = -1.f;
+	for(FBundleState& State : States)
+	{
+		if(State.Handle.IsValid() && State.Handle->IsLoadingInProgress())
+		{
+			State.Handle->CancelHandle();
+			UE_LOG(LogTemp, Display, TEXT("%s: canceled pre-warming %s"), *GetFullName(), *State.Name.ToString())
+		}
+	}
+}
+
+void UMyAssetPrewarm::LogReport() const
+{
+	for(const FBundleState& State : States)
+	{
+		UE_LOG
+			( LogTemp
+			, Display
+			, TEXT("Prewarm: bundle %-10s %s")
+			, *State.Name.ToString()
+			, State.LoadSeconds >= 0.
+				? *FString::Printf(TEXT("loaded in %.3f s"), State.LoadSeconds)
+				: State.Handle.IsValid() && State.Handle->WasCanceled() ? TEXT("canceled") : TEXT("loading")
+			)
+	}
+	for(int32 i = 0; i < LevelLoads.Num(); ++i)
+	{
+		const FLevelLoad& Load = LevelLoads[i];
+		UE_LOG
+			( LogTemp
+			, Display
+			, TEXT("Prewarm: level load %d %-20s %.3f s, longest frame after %.1f ms, pre-warming %s")
+			, i + 1
+			, *Load.Map
+			, Load.LoadSeconds
+			, Load.MaxFrameMs
+			, *Load.Prewarm
+			)
+	}
+}
+
+bool UMyAssetPrewarm::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// no main menu to idle in
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UMyAssetPrewarm::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	bEnabled = !FParse::Param(FCommandLine::Get(), TEXT("NoPrewarm"));
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UMyAssetPrewarm::HandlePreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UMyAssetPrewarm::HandlePostLoadMap);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMyAssetPrewarm::Tick));
+}
+
+void UMyAssetPrewarm::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	CancelPrewarm();
+	for(FBundleState& State : States)
+	{
+		if(State.Handle.IsValid())
+		{
+			State.Handle->ReleaseHandle();
+		}
+	}
+	States.Reset();
+	Super::Deinitialize();
+}
+
+void UMyAssetPrewarm::HandlePreLoadMap(const FString& MapName)
+{
+	PreLoadMapTime = FPlatformTime::Seconds();
+	// nothing waits in the background while the level loads, the level load flushes pending async loads anyway
+	StartCountdown = -1.f;
+}
+
+void UMyAssetPrewarm::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	// the game instance updates the current level before traveling, thus it's already the new one
+	UMyLocalPlayer* LocalPlayer = Cast<UMyLocalPlayer>(GetGameInstance()->GetFirstGamePlayer());
+	if(!LocalPlayer || LocalPlayer->GetIsInMainMenu())
+	{
+		if(bEnabled && !bStarted)
+		{
+			StartCountdown = StartDelay;
+		}
+		return;
+	}
+	if(PreLoadMapTime <= 0.)
+	{
+		return;
+	}
+	FLevelLoad& Load = LevelLoads.AddDefaulted_GetRef();
+	Load.Map = LoadedWorld ? UWorld::RemovePIEPrefix(LoadedWorld->GetMapName()) : FString();
+	Load.LoadSeconds = FPlatformTime::Seconds() - PreLoadMapTime;
+	Load.Prewarm = GetPrewarmState();
+	HitchRemaining = HitchWindow;
+	PreLoadMapTime = 0.;
+}
+
+bool UMyAssetPrewarm::Tick(float DeltaTime)
+{
+	if(StartCountdown >= 0.f)
+	{
+		StartCountdown -= DeltaTime;
+		if(StartCountdown < 0.f)
+		{
+			StartPrewarm();
+		}
+	}
+	if(HitchRemaining > 0.f && !LevelLoads.IsEmpty())
+	{
+		HitchRemaining -= DeltaTime;
+		LevelLoads.Last().MaxFrameMs = FMath::Max(LevelLoads.Last().MaxFrameMs, DeltaTime * 1000.f);
+	}
+	return true;
+}
+
+FString UMyAssetPrewarm::GetPrewarmState() const
+{
+	if(States.IsEmpty())
+	{
+		return bEnabled ? TEXT("not started") : TEXT("off");
+	}
+	int32 Loaded = 0;
+	for(const FBundleState& State : States)
+	{
+		Loaded += State.LoadSeconds >= 0. ? 1 : 0;
+	}
+	return Loaded == States.Num() ? FString(TEXT("done")) : FString::Printf(TEXT("%d/%d bundles"), Loaded, States.Num());
+}
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Loading/MyLoadingScreenSubsystem.h"
+
+#include "Diagnostics/MyMemoryTags.h"
+#include "MoviePlayer.h"
+#include "Loading/SMyLoadingScreen.h"
+#include "Widgets/SWeakWidget.h"
+
+bool UMyLoadingScreenSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// nobody to look at it
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UMyLoadingScreenSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_HUD);
+	Super::Initialize(Collection);
+
+	LoadingScreen = SNew(SMyLoadingScreen);
+
+	// The movie player binds `PreLoadMap` itself and starts playing right away if a loading screen is set up. We bind
+	// after it and multicast delegates broadcast in reverse order of binding, thus our handler sets up the loading
+	// screen just in time.
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UMyLoadingScreenSubsystem::HandlePreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UMyLoadingScreenSubsystem::HandlePostLoadMap);
+
+	UMyGISubsystem* GISub = Collection.InitializeDependency<UMyGISubsystem>();
+	SessionStageHandle = GISub->OnSessionStage.AddUObject(this, &UMyLoadingScreenSubsystem::HandleSessionStage);
+}
+
+void UMyLoadingScreenSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	if(UMyGISubsystem* GISub = GetGameInstance()->GetSubsystem<UMyGISubsystem>())
+	{
+		GISub->OnSessionStage.Remove(SessionStageHandle);
+	}
+	HideFromViewport();
+	LoadingScreen.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMyLoadingScreenSubsystem::HandlePreLoadMap(const FString& MapName)
+{
+	// the viewport goes away with the old world; from here on, the movie player owns the widget
+	HideFromViewport();
+	LoadingScreen->SetMapName(MapName);
+
+	IGameMoviePlayer* MoviePlayer = GetMoviePlayer();
+	if(MoviePlayer == nullptr || !IsMoviePlayerEnabled())
+	{
+		// e.g. in the editor
+		return;
+	}
+	FLoadingScreenAttributes Attributes;
+	Attributes.WidgetLoadingScreen = LoadingScreen;
+	Attributes.bAutoCompleteWhenLoadingCompletes = true;
+	// no movie, just our widget; the movie player keeps ticking it on its own thread
+	Attributes.bMoviesAreSkippable = false;
+	MoviePlayer->SetupLoadingScreen(Attributes);
+}
+
+void UMyLoadingScreenSubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	LoadingScreen->SetMapName(FString());
+	// travelling was the last thing to wait for, unless the session stage says otherwise
+	HandleSessionStage(GetGameInstance()->GetSubsystem<UMyGISubsystem>()->GetSessionStage());
+}
+
+void UMyLoadingScreenSubsystem::HandleSessionStage(ESessionStage NewStage)
+{
+	LoadingScreen->SetStage(NewStage);
+	switch(NewStage)
+	{
+	case ESessionStage::LoggingIn:
+	case ESessionStage::Creating:
+	case ESessionStage::Searching:
+	case ESessionStage::Found:
+	case ESessionStage::Joining:
+	case ESessionStage::Leaving:
+		ShowInViewport();
+		break;
+	default:
+		HideFromViewport();
+	}
+}
+
+void UMyLoadingScreenSubsystem::ShowInViewport()
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_HUD);
+	UGameViewportClient* Viewport = GetGameInstance()->GetGameViewportClient();
+	if(ViewportContent.IsValid() || Viewport == nullptr)
+	{
+		return;
+	}
+	// on top of the menu, which sits at z-order 0
+	ViewportContent = SNew(SWeakWidget).PossiblyNullContent(LoadingScreen);
+	Viewport->AddViewportWidgetContent(ViewportContent.ToSharedRef(), 100);
+}
+
+void UMyLoadingScreenSubsystem::HideFromViewport()
+{
+	if(!ViewportContent.IsValid())
+	{
+		return;
+	}
+	if(UGameViewportClient* Viewport = GetGameInstance()->GetGameViewportClient())
+	{
+		Viewport->RemoveViewportWidgetContent(ViewportContent.ToSharedRef());
+	}
+	ViewportContent.Reset();
+}
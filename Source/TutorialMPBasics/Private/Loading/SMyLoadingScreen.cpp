@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Loading/SMyLoadingScreen.h"
+
+#include "Widgets/Images/SThrobber.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Notifications/SProgressBar.h"
+#include "Widgets/Text/STextBlock.h"
+
+#define LOCTEXT_NAMESPACE "LoadingScreen"
+
+void SMyLoadingScreen::Construct(const FArguments& InArgs)
+{
+	const UEnum* StageEnum = StaticEnum<ESessionStage>();
+	for(int32 i = 0; i < StageEnum->NumEnums() - 1; ++i)
+	{
+		StageTexts.Add(StageEnum->GetDisplayNameTextByIndex(i));
+	}
+
+	ChildSlot
+	[
+		SNew(SBorder)
+		.BorderImage(FCoreStyle::Get().GetBrush("BlackBrush"))
+		.HAlign(HAlign_Center)
+		.VAlign(VAlign_Center)
+		[
+			SNew(SBox)
+			.WidthOverride(480.f)
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(0.f, 0.f, 0.f, 8.f)
+				[
+					SNew(STextBlock)
+					.Text(this, &SMyLoadingScreen::GetStageText)
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(0.f, 0.f, 0.f, 8.f)
+				[
+					SNew(SProgressBar)
+					// an unset percentage makes the progress bar show a marquee
+					.Percent(this, &SMyLoadingScreen::GetProgress)
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.FillWidth(1.f)
+					[
+						SNew(STextBlock)
+						.Text(this, &SMyLoadingScreen::GetProgressText)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SThrobber)
+					]
+				]
+			]
+		]
+	];
+}
+
+void SMyLoadingScreen::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	// `GetNumAsyncPackages` only reads a counter, but there is no point in doing even that every frame
+	TimeSinceSample += InDeltaTime;
+	if(TimeSinceSample < SampleInterval)
+	{
+		return;
+	}
+	TimeSinceSample = 0.f;
+	PendingPackages = GetNumAsyncPackages();
+	PeakPendingPackages = PendingPackages > 0 ? FMath::Max(PeakPendingPackages, PendingPackages) : 0;
+}
+
+void SMyLoadingScreen::SetStage(ESessionStage NewStage)
+{
+	Stage = static_cast<uint8>(NewStage);
+}
+
+void SMyLoadingScreen::SetMapName(const FString& NewMapName)
+{
+	FScopeLock Lock(&MapNameLock);
+	MapText = FText::FromString(FPackageName::GetShortName(NewMapName));
+}
+
+FText SMyLoadingScreen::GetStageText() const
+{
+	const uint8 CurrentStage = Stage;
+	return StageTexts.IsValidIndex(CurrentStage) ? StageTexts[CurrentStage] : FText::GetEmpty();
+}
+
+FText SMyLoadingScreen::GetProgressText() const
+{
+	FText Map;
+	{
+		FScopeLock Lock(&MapNameLock);
+		Map = MapText;
+	}
+	if(PendingPackages == 0)
+	{
+		return Map;
+	}
+	return FText::Format(LOCTEXT("Loading", "loading {0}: {1} packages pending"), Map, PendingPackages);
+}
+
+TOptional<float> SMyLoadingScreen::GetProgress() const
+{
+	// async loading doesn't know the total number of packages of a map up front; the fraction of the largest number
+	// of packages in flight that is done by now is the best estimate we get without stalling the loader
+	if(PeakPendingPackages <= 0)
+	{
+		return TOptional<float>();
+	}
+	return 1.f - static_cast<float>(PendingPackages) / PeakPendingPackages;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Lockstep/LockstepSim.h"
+
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	// same as `AMyPawn::AccelerateLeft/Right`
+	const FFixed Acceleration = FFixed::FromInt(10);
+	// pawns bounce off the borders of the playing field
+	const FFixed FieldHalfWidth = FFixed::FromInt(5000);
+	// a bot changes its velocity once per 32 ticks on average
+	constexpr uint32 BotActionOdds = 32;
+
+	FFixedVector SpawnPosition(int32 Index)
+	{
+		// a grid of 16 columns, 2 m apart
+		return {FFixed::FromInt(Index / 16 * 200), FFixed::FromInt(Index % 16 * 200 - 1500), FFixed::FromInt(100)};
+	}
+}
+
+void FLockstepSim::Init(int32 InTickRate, int32 NumBots, uint32 Seed)
+{
+	Tick = 0;
+	TickRate = FMath::Max(InTickRate, 1);
+	// xorshift must not start at 0
+	RandomState = Seed != 0 ? Seed : 1;
+	Entities.Reset();
+	for(int32 i = 0; i < NumBots; ++i)
+	{
+		FEntity& Bot = Entities.AddDefaulted_GetRef();
+		Bot.Position = SpawnPosition(i);
+	}
+}
+
+void FLockstepSim::Step(const FLockstepFrame& Frame)
+{
+	check(Frame.Tick == Tick + 1);
+	Tick = Frame.Tick;
+
+	for(const FLockstepCommand& Command : Frame.Commands)
+	{
+		if(Command.PlayerId == INDEX_NONE)
+		{
+			// that's a bot
+			continue;
+		}
+		const int32 Index = FindPlayer(Command.PlayerId);
+		switch(Command.Command)
+		{
+		case ELockstepCommand::Join:
+			if(Index == INDEX_NONE)
+			{
+				FEntity& Entity = Entities.AddDefaulted_GetRef();
+				Entity.PlayerId = Command.PlayerId;
+				Entity.Position = SpawnPosition(Entities.Num() - 1);
+			}
+			break;
+		case ELockstepCommand::Leave:
+			if(Index != INDEX_NONE)
+			{
+				// keeps the order, which all peers have to agree on
+				Entities.RemoveAt(Index);
+			}
+			break;
+		case ELockstepCommand::Left:
+			if(Index != INDEX_NONE)
+			{
+				Entities[Index].Velocity.Y -= Acceleration;
+			}
+			break;
+		case ELockstepCommand::Right:
+			if(Index != INDEX_NONE)
+			{
+				Entities[Index].Velocity.Y += Acceleration;
+			}
+			break;
+		}
+	}
+
+	const FFixed DeltaTime = FFixed::FromRatio(1, TickRate);
+	for(FEntity& Entity : Entities)
+	{
+		if(Entity.PlayerId == INDEX_NONE && NextRandom() % BotActionOdds == 0)
+		{
+			Entity.Velocity.Y += NextRandom() % 2 == 0 ? Acceleration : -Acceleration;
+		}
+		Entity.Position += Entity.Velocity * DeltaTime;
+		if((Entity.Position.Y > FieldHalfWidth && Entity.Velocity.Y > FFixed()) || (Entity.Position.Y < -FieldHalfWidth && Entity.Velocity.Y < FFixed()))
+		{
+			Entity.Velocity.Y = -Entity.Velocity.Y;
+		}
+	}
+}
+
+uint32 FLockstepSim::GetChecksum() const
+{
+	TArray<uint8> Bytes;
+	Save(Bytes);
+	return FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+}
+
+void FLockstepSim::Save(TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes);
+	const_cast<FLockstepSim*>(this)->Serialize(Writer);
+}
+
+bool FLockstepSim::Load(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	Serialize(Reader);
+	return !Reader.IsError();
+}
+
+void FLockstepSim::Serialize(FArchive& Ar)
+{
+	Ar << Tick << TickRate << RandomState;
+	int32 NumEntities = Entities.Num();
+	Ar << NumEntities;
+	if(Ar.IsLoading())
+	{
+		if(NumEntities < 0 || NumEntities > 100000)
+		{
+			Ar.SetError();
+			return;
+		}
+		Entities.SetNum(NumEntities);
+	}
+	for(FEntity& Entity : Entities)
+	{
+		Ar << Entity.PlayerId << Entity.Position << Entity.Velocity;
+	}
+}
+
+uint32 FLockstepSim::NextRandom()
+{
+	// xorshift32: cheap, and the same sequence everywhere
+	RandomState ^= RandomState << 13;
+	RandomState ^= RandomState >> 17;
+	RandomState ^= RandomState << 5;
+	return RandomState;
+}
+
+int32 FLockstepSim::FindPlayer(int32 PlayerId) const
+{
+	return Entities.IndexOfByPredicate([PlayerId] (const FEntity& Entity) { return Entity.PlayerId == PlayerId; });
+}
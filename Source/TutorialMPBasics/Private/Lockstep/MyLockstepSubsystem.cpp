@@ -0,0 +1,361 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Lockstep/MyLockstepSubsystem.h"
+
+#include "TutorialMPBasics.h"
+#include "Diagnostics/MyMemoryTags.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "MyPawn/MyPawn.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lockstep step"), STAT_LockstepStep, STATGROUP_TutorialMPBasics);
+
+namespace
+{
+	// reliable RPCs have a size limit, larger snapshots get sent in pieces
+	constexpr int32 SnapshotChunkSize = 8 * 1024;
+
+	// the host keeps its checksums for this many checksum intervals, later checksums of a client don't get compared
+	constexpr int32 ChecksumHistory = 16;
+
+	int32 GetPlayerId(const AController* PC)
+	{
+		return PC && PC->PlayerState ? PC->PlayerState->GetPlayerId() : INDEX_NONE;
+	}
+
+	FAutoConsoleCommandWithWorld LockstepCommand
+		( TEXT("mp.Lockstep")
+		, TEXT("Log tick, entity count, bandwidth and checksum statistics of the lockstep mode")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyLockstepSubsystem* Lockstep = World->GetSubsystem<UMyLockstepSubsystem>())
+			{
+				Lockstep->LogStats();
+			}
+		})
+		);
+}
+
+bool UMyLockstepSubsystem::IsLockstepHost() const
+{
+	return bLockstepRequested && GetWorld()->GetNetMode() != NM_Client;
+}
+
+void UMyLockstepSubsystem::AddPlayer(AMyPlayerController* PC)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Lockstep);
+	if(!IsValid(PC))
+	{
+		return;
+	}
+	if(!bRunning)
+	{
+		StartHost();
+	}
+	PendingCommands.Add({GetPlayerId(PC), ELockstepCommand::Join});
+	// the host's own player (listen server) shares our simulation
+	if(!PC->IsLocalController())
+	{
+		SendSnapshot(PC);
+	}
+}
+
+void UMyLockstepSubsystem::RemovePlayer(AMyPlayerController* PC)
+{
+	PendingCommands.Add({GetPlayerId(PC), ELockstepCommand::Leave});
+	Peers.Remove(PC);
+}
+
+void UMyLockstepSubsystem::SubmitAction(const AMyPlayerController* PC, EAction Action)
+{
+	if(bRunning)
+	{
+		PendingCommands.Add({GetPlayerId(PC), Action == EAction::Left ? ELockstepCommand::Left : ELockstepCommand::Right});
+	}
+}
+
+void UMyLockstepSubsystem::ReceiveSnapshot(int32 TotalSize, const TArray<uint8>& Chunk)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Lockstep);
+	IncomingSnapshot.Append(Chunk);
+	if(IncomingSnapshot.Num() < TotalSize)
+	{
+		return;
+	}
+	if(!Sim.Load(IncomingSnapshot))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: corrupt lockstep snapshot (%d bytes)"), *GetFullName(), IncomingSnapshot.Num())
+	}
+	IncomingSnapshot.Reset();
+	// the host sends all frames after the snapshot next, including any we might have already (resynchronization)
+	PendingFrames.Reset();
+	SinceStep = 0.f;
+	bRunning = true;
+	UE_LOG(LogTemp, Display, TEXT("%s: lockstep snapshot at tick %d, %d entities"), *GetFullName(), Sim.GetTick(), Sim.GetEntities().Num())
+}
+
+void UMyLockstepSubsystem::ReceiveFrame(const FLockstepFrame& Frame)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Lockstep);
+	if(!bRunning)
+	{
+		return;
+	}
+	const int32 ExpectedTick = (PendingFrames.IsEmpty() ? Sim.GetTick() : PendingFrames.Last().Tick) + 1;
+	if(Frame.Tick < ExpectedTick)
+	{
+		return;
+	}
+	if(Frame.Tick > ExpectedTick)
+	{
+		// frames are reliable and ordered, thus this is a bug; we wait for the host's checksum comparison to resync
+		UE_LOG(LogTemp, Error, TEXT("%s: lockstep frame %d, expected %d"), *GetFullName(), Frame.Tick, ExpectedTick)
+		return;
+	}
+	PendingFrames.Add(Frame);
+}
+
+void UMyLockstepSubsystem::ReceiveChecksum(AMyPlayerController* PC, int32 Tick, uint32 Checksum)
+{
+	const uint32* OwnChecksum = Checksums.Find(Tick);
+	if(!OwnChecksum)
+	{
+		// too old, or from the future
+		return;
+	}
+	++ChecksumsCompared;
+	if(*OwnChecksum != Checksum)
+	{
+		++Desyncs;
+		UE_LOG(LogTemp, Error, TEXT("%s: lockstep desync of %s at tick %d, resynchronizing"), *GetFullName(), *PC->GetFullName(), Tick)
+		SendSnapshot(PC);
+	}
+}
+
+void UMyLockstepSubsystem::LogStats() const
+{
+	UE_LOG
+		( LogTemp
+		, Display
+		, TEXT("%s: lockstep %s, tick %d, %d entities, %d peers; sent %d frames, %lld bytes, %d snapshots (%d bytes); %d checksums compared, %d desyncs; last step %.3f ms")
+		, *GetFullName()
+		, !bRunning ? TEXT("off") : IsLockstepHost() ? TEXT("host") : TEXT("client")
+		, Sim.GetTick()
+		, Sim.GetEntities().Num()
+		, Peers.Num()
+		, FramesSent
+		, BytesSent
+		, SnapshotsSent
+		, Snapshot.Num()
+		, ChecksumsCompared
+		, Desyncs
+		, LastStepTime * 1000.
+		)
+}
+
+bool UMyLockstepSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && Cast<UWorld>(Outer)->IsGameWorld();
+}
+
+void UMyLockstepSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// the net mode isn't known yet, cf. `IsLockstepHost`; clients don't need the switch, they start with the snapshot
+	bLockstepRequested = FParse::Param(FCommandLine::Get(), TEXT("Lockstep"));
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMyLockstepSubsystem::HandleWorldPostActorTick);
+}
+
+void UMyLockstepSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	Visuals.Reset();
+	Super::Deinitialize();
+}
+
+void UMyLockstepSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Lockstep);
+	if(World != GetWorld() || !bRunning)
+	{
+		return;
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LockstepStep);
+		const double StartTime = FPlatformTime::Seconds();
+		if(IsLockstepHost())
+		{
+			StepHost(DeltaSeconds);
+		}
+		else
+		{
+			StepClient(DeltaSeconds);
+		}
+		LastStepTime = FPlatformTime::Seconds() - StartTime;
+	}
+	// nobody looks at a dedicated server
+	if(GetWorld()->GetNetMode() != NM_DedicatedServer)
+	{
+		UpdateVisuals();
+	}
+}
+
+void UMyLockstepSubsystem::StartHost()
+{
+	// the seed is part of the state, thus clients get it with the snapshot
+	Sim.Init(TickRate, Bots, FMath::Rand());
+	Sim.Save(Snapshot);
+	FramesSinceSnapshot.Reset();
+	SinceStep = 0.f;
+	bRunning = true;
+}
+
+void UMyLockstepSubsystem::StepHost(float DeltaSeconds)
+{
+	const float TickSeconds = 1.f / FMath::Max(TickRate, 1);
+	SinceStep += DeltaSeconds;
+	Peers.RemoveAll([] (const TWeakObjectPtr<AMyPlayerController>& Peer) { return !Peer.IsValid(); });
+
+	int32 Steps = 0;
+	for(; SinceStep >= TickSeconds && Steps < MaxStepsPerFrame; ++Steps)
+	{
+		SinceStep -= TickSeconds;
+		FLockstepFrame Frame;
+		Frame.Tick = Sim.GetTick() + 1;
+		Frame.Commands = MoveTemp(PendingCommands);
+		PendingCommands.Reset();
+		Sim.Step(Frame);
+
+		// also empty frames: they tell the clients that they may advance
+		for(const TWeakObjectPtr<AMyPlayerController>& Peer : Peers)
+		{
+			Peer->ClientRPC_LockstepFrame(Frame);
+			++FramesSent;
+			BytesSent += sizeof(Frame.Tick) + Frame.Commands.Num() * (sizeof(int32) + sizeof(ELockstepCommand));
+		}
+
+		const int32 Interval = FMath::Max(ChecksumInterval, 1);
+		if(Frame.Tick % Interval == 0)
+		{
+			Checksums.Add(Frame.Tick, Sim.GetChecksum());
+			Checksums.Remove(Frame.Tick - ChecksumHistory * Interval);
+		}
+		if(Frame.Tick % FMath::Max(SnapshotInterval, 1) == 0)
+		{
+			Sim.Save(Snapshot);
+			FramesSinceSnapshot.Reset();
+		}
+		else
+		{
+			FramesSinceSnapshot.Add(MoveTemp(Frame));
+		}
+	}
+	// after a hitch, we rather fall behind than stall even longer catching up
+	if(Steps == MaxStepsPerFrame)
+	{
+		SinceStep = FMath::Min(SinceStep, TickSeconds);
+	}
+}
+
+void UMyLockstepSubsystem::StepClient(float DeltaSeconds)
+{
+	AMyPlayerController* PC = GetWorld()->GetFirstPlayerController<AMyPlayerController>();
+	const int32 Steps = FMath::Min(PendingFrames.Num(), MaxStepsPerFrame);
+	for(int32 i = 0; i < Steps; ++i)
+	{
+		Sim.Step(PendingFrames[i]);
+		if(Sim.GetTick() % FMath::Max(ChecksumInterval, 1) == 0 && IsValid(PC))
+		{
+			PC->ServerRPC_LockstepChecksum(Sim.GetTick(), Sim.GetChecksum());
+		}
+	}
+	PendingFrames.RemoveAt(0, Steps);
+	SinceStep = Steps > 0 ? 0.f : SinceStep + DeltaSeconds;
+}
+
+void UMyLockstepSubsystem::SendSnapshot(AMyPlayerController* PC)
+{
+	// reliable RPCs arrive in order: first the snapshot, then the frames since, then the regular frames
+	for(int32 Offset = 0; Offset < Snapshot.Num(); Offset += SnapshotChunkSize)
+	{
+		const TArray<uint8> Chunk(Snapshot.GetData() + Offset, FMath::Min(SnapshotChunkSize, Snapshot.Num() - Offset));
+		PC->ClientRPC_LockstepSnapshot(Snapshot.Num(), Chunk);
+		BytesSent += Chunk.Num();
+	}
+	for(const FLockstepFrame& Frame : FramesSinceSnapshot)
+	{
+		PC->ClientRPC_LockstepFrame(Frame);
+		++FramesSent;
+		BytesSent += sizeof(Frame.Tick) + Frame.Commands.Num() * (sizeof(int32) + sizeof(ELockstepCommand));
+	}
+	Peers.AddUnique(PC);
+	++SnapshotsSent;
+}
+
+void UMyLockstepSubsystem::UpdateVisuals()
+{
+	UWorld* World = GetWorld();
+	const TArray<FLockstepSim::FEntity>& Entities = Sim.GetEntities();
+
+	// entities of the same class are interchangeable, only the number of visuals has to match
+	while(Visuals.Num() > Entities.Num())
+	{
+		if(IsValid(Visuals.Last()))
+		{
+			Visuals.Last()->Destroy();
+		}
+		Visuals.Pop();
+	}
+	if(Visuals.Num() < Entities.Num())
+	{
+		// the game mode only exists on the host, but its defaults are known to clients, too
+		const AGameStateBase* GameState = World->GetGameState();
+		const AGameModeBase* GameModeDefaults = IsValid(GameState) ? GameState->GetDefaultGameMode() : nullptr;
+		UClass* PawnClass = GameModeDefaults ? GameModeDefaults->DefaultPawnClass.Get() : nullptr;
+		if(!IsValid(PawnClass) || !PawnClass->IsChildOf<AMyPawn>())
+		{
+			return;
+		}
+		while(Visuals.Num() < Entities.Num())
+		{
+			// local to this peer: not replicated, and not moving by itself; unregistered, thus neither pushed by
+			// pawn collisions nor recorded for lag compensation, only the simulation decides where it is
+			AMyPawn* Pawn = World->SpawnActorDeferred<AMyPawn>(PawnClass, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+			Pawn->SetReplicates(false);
+			Pawn->bRegisterWithSubsystem = false;
+			Pawn->PrimaryActorTick.bStartWithTickEnabled = false;
+			Pawn->FinishSpawning(FTransform::Identity);
+			Visuals.Add(Pawn);
+		}
+	}
+
+	// between two ticks, the pawns keep moving with their velocity
+	const float Extrapolation = FMath::Min(SinceStep, 1.f / FMath::Max(TickRate, 1));
+	for(int32 i = 0; i < Entities.Num(); ++i)
+	{
+		if(IsValid(Visuals[i]))
+		{
+			Visuals[i]->SetActorLocation(Origin + Entities[i].Position.ToVector() + Entities[i].Velocity.ToVector() * Extrapolation);
+		}
+	}
+
+	// there are no possessed pawns, the local players look through the visual of their entity instead
+	for(FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if(!IsValid(PC) || !PC->IsLocalController())
+		{
+			continue;
+		}
+		const int32 PlayerId = GetPlayerId(PC);
+		const int32 Index = Entities.IndexOfByPredicate([PlayerId] (const FLockstepSim::FEntity& Entity) { return Entity.PlayerId == PlayerId; });
+		if(Index != INDEX_NONE && IsValid(Visuals[Index]) && PC->GetViewTarget() != Visuals[Index])
+		{
+			PC->SetViewTarget(Visuals[Index]);
+		}
+	}
+}
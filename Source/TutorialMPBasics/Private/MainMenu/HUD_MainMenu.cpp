@@ -3,29 +3,36 @@
 
 #include "MainMenu/HUD_MainMenu.h"
 
+#include "Diagnostics/MyEventLog.h"
+#include "Diagnostics/MyMemoryTags.h"
 #include "MainMenu/UW_MainMenu.h"
 #include "Blueprint/UserWidget.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
 
 void AHUD_MainMenu::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(TutorialMPBasics_HUD);
 	// this method can be equally well implemented in Blueprint without problem
 	// I just happen to prefer C++ code in about 100% of the cases
 	Super::BeginPlay();
 
+	// split screen: one menu for all local players, across the whole screen; the first player owns it
+	if(UGameViewportClient* Viewport = GetWorld()->GetGameViewport())
+	{
+		Viewport->SetForceDisableSplitscreen(true);
+	}
+	if(!GetOwningPlayerController()->GetLocalPlayer()->IsPrimaryPlayer())
+	{
+		return;
+	}
+
 	if(!IsValid(MainMenuClass))
 	{
-		// in case we forgot to set the MainMenuClass field in the Blueprint "BP_HUD_MainMenu", we want an error
-		// that reminds us instead of a crash of the editor
-		UE_LOG
-			// `LogActor` isn't exactly a meaningful category for logging, but neither "LogUI" nor "LogHUD" exist
-			// and LogSlate implies an additional include
-			( LogActor 
-			, Error
-			, TEXT("%s: MainMenuClass null")
-			// always including `GetFullName()` like this, helps us identifying the exact object that caused this
-			// custom error (or other log output), at the expense of more verbose output
-			, *GetFullName()
-			)
+		// in case we forgot to set the MainMenuClass field in the Blueprint "BP_HUD_MainMenu", we want an event
+		// that reminds us instead of a crash of the editor; the event log records which object it was, cf.
+		// "Diagnostics/MyEventLog.h" (`mp.EventLog.Echo 1` prints it to the regular log, too)
+		MP_EVENT(HUDClassMissing, this, FName(TEXT("MainMenuClass")));
 		return;
 	}
 
@@ -2,15 +2,25 @@
 
 
 #include "Modes/MyGISubsystem.h"
+#include "Diagnostics/MyEventLog.h"
+#include "Diagnostics/MyMemoryTags.h"
 #include "OnlineSubsystemUtils.h"
 #include "MainMenu/HUD_MainMenu.h"
 
 #include "Modes/MyGameInstance.h"
 #include "Modes/MyLocalPlayer.h"
+#include "Online/OnlineSubsystemMock.h"
+
+namespace
+{
+	// seconds to wait for `DestroySession` to complete, before leaving counts as failed
+	constexpr float DestroySessionTimeout = 10.f;
+}
 
 bool UMyGISubsystem::CreateSession(const FLocalPlayerContext& LPC, FHostSessionConfig SessionConfig,
                                    TFunction<void(FName, bool)> Callback)
 {
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Sessions);
 	const IOnlineSessionPtr SI = GetSessionInterface();
 
 	// syntax for unpacking of structs
@@ -53,7 +63,7 @@ bool UMyGISubsystem::CreateSession(const FLocalPlayerContext& LPC, FHostSessionC
 	{
 		// We expect this delegate to be unbound the first time the user creates a session.
 		// If it isn't, we get a warning.
-		UE_LOG(LogNet, Warning, TEXT("%s: OnCreateSessionCompleteDelegates: was bound, clearing"), *GetFullName())
+		MP_EVENT(SessionDelegateCleared, this, FName(TEXT("OnCreateSessionCompleteDelegates")));
 		SI->OnCreateSessionCompleteDelegates.Clear();
 	}
 
@@ -69,7 +79,15 @@ bool UMyGISubsystem::CreateSession(const FLocalPlayerContext& LPC, FHostSessionC
 	 * "UMyGameInstance.cpp", lines 15-39
 	 * 
 	 */
-	SI->OnCreateSessionCompleteDelegates.AddLambda(Callback);
+	CreateSessionCompleteHandle = SI->OnCreateSessionCompleteDelegates.AddLambda([this, Callback] (FName SessionName, bool bSuccess)
+	{
+		SetSessionStage(bSuccess ? ESessionStage::Created : ESessionStage::Failed);
+		if(bSuccess)
+		{
+			RegisterSplitscreenPlayers();
+		}
+		Callback(SessionName, bSuccess);
+	});
 
 	/*
 	 * Maybe you have seen code like this in some tutorial:
@@ -80,8 +98,9 @@ bool UMyGISubsystem::CreateSession(const FLocalPlayerContext& LPC, FHostSessionC
 	 * By passing the local player index, a unique net id will be created for us without problem.
 	 * Note that often, instead of `GetLocalPlayer()->GetIndexInGameInstance()` just `0` is provided.
 	 * The 0 means that the session is always created in the name of the local player with index 0.
-	 * This is always safe, as split/shared screen isn't usually possible at the same time as LAN/online multiplayer.
 	 * As long as there is only one local player (not split/shared screen), its index is 0.
+	 * With split screen (cf. `UMyGameInstance::AddSplitscreenPlayer`), any of the local players may host or join;
+	 * the others get registered with the session afterwards, cf. `RegisterSplitscreenPlayers`.
 	 * 
 	 * Also, the parameter `FName SessionName`, set to `NAME_GameSession`, can be any `FName`,
 	 * e.g. `FName(TEXT("my custom session")`. However, don't mistake the `SessionName` parameter for some sort of
@@ -92,11 +111,14 @@ bool UMyGISubsystem::CreateSession(const FLocalPlayerContext& LPC, FHostSessionC
 	 * In the end, you can put any FName there. Just make sure to be consistent in always putting the same.
 	 * 
 	 */
+	SessionOwnerId = LPC.GetLocalPlayer()->GetControllerId();
+	SetSessionStage(ESessionStage::Creating);
 	return SI->CreateSession(LPC.GetLocalPlayer()->GetIndexInGameInstance(), NAME_GameSession, *LastSessionSettings);
 }
 
 void UMyGISubsystem::JoinSession(const FLocalPlayerContext& LPC, TFunction<void(ECurrentLevel, EOnJoinSessionCompleteResult::Type)> Callback)
 {
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Sessions);
 	const IOnlineSessionPtr SI = GetSessionInterface();
 	const TSharedRef<FOnlineSessionSearch> LastSessionSearch = MakeShared<FOnlineSessionSearch>();
 	LastSessionSearch->MaxSearchResults = 10000;
@@ -105,20 +127,48 @@ void UMyGISubsystem::JoinSession(const FLocalPlayerContext& LPC, TFunction<void(
 
 	if(SI->OnFindSessionsCompleteDelegates.IsBound())
 	{
-		UE_LOG(LogNet, Warning, TEXT("%s: OnFindSessionsCompleteDelegates: was bound, clearing"), *GetFullName())
+		MP_EVENT(SessionDelegateCleared, this, FName(TEXT("OnFindSessionsCompleteDelegates")));
 		SI->OnFindSessionsCompleteDelegates.Clear();
 	}
-	SI->OnFindSessionsCompleteDelegates.AddLambda([this, LastSessionSearch, LPC, Callback, SI] (bool bSuccess)
+	FindSessionsCompleteHandle = SI->OnFindSessionsCompleteDelegates.AddLambda([this, LastSessionSearch, LPC, Callback, SI] (bool bSuccess)
 	{
-		// In case we find a session, we just join immediately;
+		LLM_SCOPE_BYTAG(TutorialMPBasics_Sessions);
+		// In case we find a session, we just join the best one immediately;
 		// more thoroughly, you make a list of available sessions with their respective custom name and offer the player
 		// to join a specific one
-		const TArray<FOnlineSessionSearchResult> Results = LastSessionSearch->SearchResults;
-		if(bSuccess && !Results.IsEmpty())
+		// (a reference: copying up to 10000 results, each with its own settings map, just to look at the first one
+		// doubles the peak memory of the search)
+		const TArray<FOnlineSessionSearchResult>& Results = LastSessionSearch->SearchResults;
+		const FOnlineSessionSearchResult* Result = nullptr;
+		float BestLoad = 0.f;
+		// split-screen players need a slot each, they are players of the session like everybody else
+		const int32 NumLocalPlayers = GetGameInstance()->GetNumLocalPlayers();
+		for(const FOnlineSessionSearchResult& Candidate : Results)
 		{
+			// a host that is shutting down stops advertising its session, but search results may be older than that
+			bool bDraining = false;
+			Candidate.Session.SessionSettings.Get(SETTING_DRAINING, bDraining);
+			const bool bFull = Candidate.Session.NumOpenPublicConnections + Candidate.Session.NumOpenPrivateConnections < NumLocalPlayers
+				&& Candidate.Session.SessionSettings.NumPublicConnections + Candidate.Session.SessionSettings.NumPrivateConnections > 0;
+			if(bDraining || bFull)
+			{
+				continue;
+			}
+			// the least loaded host, cf. `UMySessionAdvertiser`; the lower ping among equally loaded ones
+			float Load = 0.f;
+			Candidate.Session.SessionSettings.Get(SETTING_LOAD, Load);
+			if(!Result || Load < BestLoad - .1f || (Load < BestLoad + .1f && Candidate.PingInMs < Result->PingInMs))
+			{
+				Result = &Candidate;
+				BestLoad = Load;
+			}
+		}
+		if(bSuccess && Result)
+		{
+			SetSessionStage(ESessionStage::Found);
 			if(SI->OnJoinSessionCompleteDelegates.IsBound())
 			{
-				UE_LOG(LogNet, Warning, TEXT("%s: OnJoinSessionCompleteDelegates: was bound, clearing"), *GetFullName())
+				MP_EVENT(SessionDelegateCleared, this, FName(TEXT("OnJoinSessionCompleteDelegates")));
 				SI->OnJoinSessionCompleteDelegates.Clear();
 			}
 			// We are inside a closure that gets executed when "FindSessionsComplete" fires, thus this line means:
@@ -126,23 +176,33 @@ void UMyGISubsystem::JoinSession(const FLocalPlayerContext& LPC, TFunction<void(
 			// ... we lookup the new level in the session settings ...
 			// ... and when we joined a session ...
 			// ... execute `Callback(NewLevel, EJoinSessionCompleteResult::Type)`
-			int32 NewLevelI;
+			// a setting that is missing or of another type leaves this untouched
+			int32 NewLevelI = (int32)ECurrentLevel::SomeLevel;
 			// the session settings can't store our enum `CurrentLevel`, we stored an `int32` instead
-			Results[0].Session.SessionSettings.Get(SETTING_LEVEL, NewLevelI);
-			SI->OnJoinSessionCompleteDelegates.AddLambda([Callback, NewLevelI] (FName, EOnJoinSessionCompleteResult::Type Type)
+			Result->Session.SessionSettings.Get(SETTING_LEVEL, NewLevelI);
+			JoinSessionCompleteHandle = SI->OnJoinSessionCompleteDelegates.AddLambda([this, Callback, NewLevelI] (FName, EOnJoinSessionCompleteResult::Type Type)
 			{
+				SetSessionStage(Type == EOnJoinSessionCompleteResult::Success ? ESessionStage::Joined : ESessionStage::Failed);
+				if(Type == EOnJoinSessionCompleteResult::Success)
+				{
+					RegisterSplitscreenPlayers();
+				}
 				// to convert `int32` to the enum, `static_cast` is just fine
 				Callback(static_cast<ECurrentLevel>(NewLevelI), Type);
 			});
-			SI->JoinSession(LPC.GetLocalPlayer()->GetIndexInGameInstance(), NAME_GameSession, Results[0]);
+			SetSessionStage(ESessionStage::Joining);
+			SI->JoinSession(LPC.GetLocalPlayer()->GetIndexInGameInstance(), NAME_GameSession, *Result);
 		}
 		else
 		{
+			SetSessionStage(ESessionStage::Failed);
 			UE_LOG(LogNet, Error, TEXT("%s: couldn't find session."), *GetFullName())
 		}
 	});
 
 	// after having registered the callback (`AddLambda`) for the FindSessionCompleteEvent, we go and find sessions
+	SessionOwnerId = LPC.GetLocalPlayer()->GetControllerId();
+	SetSessionStage(ESessionStage::Searching);
 	SI->FindSessions
 		(LPC.GetLocalPlayer()->GetIndexInGameInstance()
 		, LastSessionSearch
@@ -151,33 +211,108 @@ void UMyGISubsystem::JoinSession(const FLocalPlayerContext& LPC, TFunction<void(
 
 void UMyGISubsystem::LeaveSession()
 {
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Sessions);
+	// already on the way out: with split screen, e.g., every local player controller gets told to leave by a
+	// draining host, cf. `AMyPlayerController::ClientRPC_ServerDraining`
+	if(bDestroyPending)
+	{
+		return;
+	}
 	const IOnlineSessionPtr SI = GetSessionInterface();
 	if(SI->GetNamedSession(NAME_GameSession))
 	{
 		if(SI->OnDestroySessionCompleteDelegates.IsBound())
 		{
-			UE_LOG(LogNet, Warning, TEXT("%s: OnDestroySessionCompleteDelegates: was bound, clearing"), *GetFullName())
+			MP_EVENT(SessionDelegateCleared, this, FName(TEXT("OnDestroySessionCompleteDelegates")));
 			SI->OnDestroySessionCompleteDelegates.Clear();
 		}
-		SI->OnDestroySessionCompleteDelegates.AddLambda([this, SI] (FName, bool bSuccess)
+		DestroySessionCompleteHandle = SI->OnDestroySessionCompleteDelegates.AddLambda([this, SI] (FName, bool bSuccess)
 		{
+			// too late, we gave up already
+			if(!bDestroyPending)
+			{
+				return;
+			}
+			if(!SI->GetNamedSession(NAME_GameSession))
+			{
+				FinishLeaveSession(true);
+			}
 			// `DestroySession` does seem to have some glitches, where the session ends up not being destroyed.
 			// Unfortunately, I regularly encounter the case where `bSuccess` is true, but the session isn't destroyed.
-			if(SI->GetNamedSession(NAME_GameSession))
+			else if(bSuccess)
 			{
-				UE_LOG(LogTemp, Warning, TEXT("%s: Failed to destroy session, trying again ..."), *GetFullName())
-				SI->DestroySession(NAME_GameSession);
+				MP_EVENT(SessionDestroyRetry, this);
+				if(!SI->DestroySession(NAME_GameSession) && bDestroyPending)
+				{
+					FinishLeaveSession(false);
+				}
 			}
 			else
 			{
-				UE_LOG(LogTemp, Warning, TEXT("%s: Session destroyed."), *GetFullName())
-				GetGameInstance()->ReturnToMainMenu();
+				FinishLeaveSession(false);
 			}
 		});
-		SI->DestroySession(NAME_GameSession);
+		// The completion may never come (e.g. the host or the online service is gone); without the timeout, we would
+		// ignore every further request to leave.
+		bDestroyPending = true;
+		SetSessionStage(ESessionStage::Leaving);
+		DestroySessionTimeoutTicker = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this] (float)
+		{
+			if(bDestroyPending)
+			{
+				FinishLeaveSession(false);
+			}
+			// once
+			return false;
+		}), DestroySessionTimeout);
+		// some online subsystems (e.g. NULL) complete right away, from within this call
+		if(!SI->DestroySession(NAME_GameSession) && bDestroyPending)
+		{
+			FinishLeaveSession(false);
+		}
+	}
+}
+
+void UMyGISubsystem::FinishLeaveSession(bool bLeft)
+{
+	bDestroyPending = false;
+	FTSTicker::GetCoreTicker().RemoveTicker(DestroySessionTimeoutTicker);
+	if(bLeft)
+	{
+		MP_EVENT(SessionDestroyed, this);
+		// the session is gone, so is any reason to listen to its interface
+		UnbindSessionDelegates();
+		SetSessionStage(ESessionStage::Left);
+		GetGameInstance()->ReturnToMainMenu();
+	}
+	else
+	{
+		// the player may try again
+		UE_LOG(LogNet, Error, TEXT("%s: couldn't destroy the session"), *GetFullName())
+		SetSessionStage(ESessionStage::Failed);
 	}
 }
 
+bool UMyGISubsystem::HasSession() const
+{
+	return GetSessionInterface()->GetNamedSession(NAME_GameSession) != nullptr;
+}
+
+bool UMyGISubsystem::UpdateSession(TFunctionRef<void(FOnlineSessionSettings&)> Edit)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Sessions);
+	const IOnlineSessionPtr SI = GetSessionInterface();
+	const FOnlineSessionSettings* CurrentSettings = SI->GetSessionSettings(NAME_GameSession);
+	if(!CurrentSettings)
+	{
+		return false;
+	}
+	FOnlineSessionSettings Settings = *CurrentSettings;
+	Edit(Settings);
+	// `bShouldRefreshOnlineData`: publish to the online service, not just update the local copy
+	return SI->UpdateSession(NAME_GameSession, Settings, true);
+}
+
 void UMyGISubsystem::ShowLoginScreen(const FLocalPlayerContext& LPC)
 {
 	FOnlineAccountCredentials OnlineAccountCredentials;
@@ -190,8 +325,9 @@ void UMyGISubsystem::ShowLoginScreen(const FLocalPlayerContext& LPC)
 	OnlineAccountCredentials.Id = "localhost:1234";
 	OnlineAccountCredentials.Token = "foo";
 
-	const IOnlineIdentityPtr OSSIdentity = Online::GetIdentityInterfaceChecked(FName(TEXT("EOS")));
+	const IOnlineIdentityPtr OSSIdentity = Online::GetIdentityInterfaceChecked(GetOnlineServiceName());
 	
+	SetSessionStage(ESessionStage::LoggingIn);
 	OSSIdentity->Login
 		( LPC.GetLocalPlayer()->GetLocalPlayerIndex()
 		, OnlineAccountCredentials
@@ -199,11 +335,12 @@ void UMyGISubsystem::ShowLoginScreen(const FLocalPlayerContext& LPC)
 	
 	// TODO: autologin for PIE
 	
-	// TODO: show some sort of loading screen: "logging in ..."
+	// the loading screen ("logging in ...") follows `SessionStage`, cf. `UMyLoadingScreenSubsystem`
 }
 
 void UMyGISubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Sessions);
 	Super::Initialize(Collection);
 
 	// When EOS not configured, warn right away.
@@ -211,14 +348,15 @@ void UMyGISubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	/*
 	 * `GetIdentityInterfaceChecked(FName(TEXT("EOS"))` causes a crash when EOS isn't configured
 	 */
-	const IOnlineIdentityPtr OSSIdentity = Online::GetIdentityInterface(GetWorld(), FName(TEXT("EOS")));
+	const IOnlineIdentityPtr OSSIdentity = Online::GetIdentityInterface(GetWorld(), GetOnlineServiceName());
 	if(!OSSIdentity.IsValid())
 	{
 		UE_LOG
 			( LogNet
 			, Warning
-			, TEXT("%s: couldn't get identity interface for EOS. Probably not configured.")
+			, TEXT("%s: couldn't get identity interface for %s. Probably not configured.")
 			, *GetFullName()
+			, *GetOnlineServiceName().ToString()
 			)
 		return;
 	}
@@ -236,19 +374,14 @@ void UMyGISubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	
 	if(OSSIdentity->OnLoginCompleteDelegates->IsBound())
 	{
-		UE_LOG(LogNet, Warning, TEXT("%s: OnLoginCompleteDelegates: was bound, clearing"), *GetFullName())
+		MP_EVENT(SessionDelegateCleared, this, FName(TEXT("OnLoginCompleteDelegates")));
 		OSSIdentity->OnLoginCompleteDelegates->Clear();
 	}
 	OSSIdentity->OnLoginCompleteDelegates->AddLambda([this] (int32 LocalUserNum, bool bSuccess, const FUniqueNetId& NewUNI, const FString& Error)
 	{
-		UE_LOG
-			( LogNet
-			, Display
-			, TEXT("%s: Login of player num %d: %s")
-			, *GetFullName()
-			, LocalUserNum
-			, bSuccess ? TEXT("success") : TEXT("failure")
-			)
+		MP_EVENT(LoginComplete, this, LocalUserNum, bSuccess);
+
+		SetSessionStage(bSuccess ? ESessionStage::None : ESessionStage::Failed);
 
 		UMyLocalPlayer* LocalPlayer = Cast<UMyLocalPlayer>(GetGameInstance()->GetLocalPlayerByIndex(LocalUserNum));
 		AHUD_MainMenu* HUDMenu = LocalPlayer->GetPlayerController(GetWorld())->GetHUD<AHUD_MainMenu>();
@@ -267,7 +400,7 @@ void UMyGISubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	
 	if(OSSIdentity->OnLogoutCompleteDelegates->IsBound())
 	{
-		UE_LOG(LogNet, Warning, TEXT("%s: OnLogoutCompleteDelegates: was bound, clearing"), *GetFullName())
+		MP_EVENT(SessionDelegateCleared, this, FName(TEXT("OnLogoutCompleteDelegates")));
 		OSSIdentity->OnLogoutCompleteDelegates->Clear();
 	}
 	OSSIdentity->OnLogoutCompleteDelegates->AddLambda([this] (int32 PlayerNum, bool bSuccess)
@@ -276,23 +409,113 @@ void UMyGISubsystem::Initialize(FSubsystemCollectionBase& Collection)
 		{
 			Cast<UMyLocalPlayer>(GetGameInstance()->GetLocalPlayerByIndex(PlayerNum))->IsLoggedIn = false;
 		}
-		UE_LOG
-			( LogNet
-			, Display
-			, TEXT("%s: Player %d log out: %s")
-			, *GetFullName()
-			, PlayerNum
-			, bSuccess ? TEXT("success") : TEXT("failure")
-			)
+		MP_EVENT(LogoutComplete, this, PlayerNum, bSuccess);
 	});
 }
 
+void UMyGISubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(DestroySessionTimeoutTicker);
+	Super::Deinitialize();
+}
+
 IOnlineSessionPtr UMyGISubsystem::GetSessionInterface() const
 {
 	return Online::GetSessionInterfaceChecked
 		( GetWorld()
 		, Cast<UMyGameInstance>(GetGameInstance())->SessionConfig.bEnableLAN
 			? FName(TEXT("NULL"))
-			: FName(TEXT("EOS"))
+			: GetOnlineServiceName()
 		);
 }
+
+FName UMyGISubsystem::GetOnlineServiceName()
+{
+	// `-MockOnline` swaps EOS for the in-process mock, cf. `FOnlineSubsystemMock`
+	static const bool bMockOnline = FParse::Param(FCommandLine::Get(), TEXT("MockOnline"));
+	return bMockOnline ? MOCK_SUBSYSTEM : FName(TEXT("EOS"));
+}
+
+int32 UMyGISubsystem::GetNumBoundSessionDelegates() const
+{
+	const IOnlineSessionPtr SI = GetSessionInterface();
+	return SI->OnCreateSessionCompleteDelegates.IsBound()
+		+ SI->OnFindSessionsCompleteDelegates.IsBound()
+		+ SI->OnJoinSessionCompleteDelegates.IsBound()
+		+ SI->OnDestroySessionCompleteDelegates.IsBound();
+}
+
+void UMyGISubsystem::UnbindSessionDelegates()
+{
+	const IOnlineSessionPtr SI = GetSessionInterface();
+	SI->OnCreateSessionCompleteDelegates.Remove(CreateSessionCompleteHandle);
+	SI->OnFindSessionsCompleteDelegates.Remove(FindSessionsCompleteHandle);
+	SI->OnJoinSessionCompleteDelegates.Remove(JoinSessionCompleteHandle);
+	SI->OnDestroySessionCompleteDelegates.Remove(DestroySessionCompleteHandle);
+	CreateSessionCompleteHandle.Reset();
+	FindSessionsCompleteHandle.Reset();
+	JoinSessionCompleteHandle.Reset();
+	DestroySessionCompleteHandle.Reset();
+}
+
+ESessionStage UMyGISubsystem::GetSessionStage(const ULocalPlayer* LocalPlayer) const
+{
+	const ESessionStage* Stage = LocalPlayer ? LocalPlayerStages.Find(LocalPlayer->GetControllerId()) : nullptr;
+	return Stage ? *Stage : ESessionStage::None;
+}
+
+void UMyGISubsystem::SetSessionStage(ESessionStage NewStage)
+{
+	SessionStage = NewStage;
+	MP_EVENT(SessionStage, this, NewStage);
+	if(SessionOwnerId != INDEX_NONE)
+	{
+		LocalPlayerStages.Add(SessionOwnerId, NewStage);
+	}
+	// when the session is gone, it's gone for everybody on this machine
+	if(NewStage == ESessionStage::Left)
+	{
+		for(TPair<int32, ESessionStage>& Stage : LocalPlayerStages)
+		{
+			Stage.Value = ESessionStage::Left;
+		}
+	}
+	OnSessionStage.Broadcast(NewStage);
+}
+
+void UMyGISubsystem::SetLocalPlayerStage(int32 ControllerId, ESessionStage NewStage)
+{
+	MP_EVENT(LocalPlayerSessionStage, this, ControllerId, NewStage);
+	LocalPlayerStages.Add(ControllerId, NewStage);
+}
+
+void UMyGISubsystem::RegisterSplitscreenPlayers()
+{
+	const IOnlineSessionPtr SI = GetSessionInterface();
+	for(const ULocalPlayer* LocalPlayer : GetGameInstance()->GetLocalPlayers())
+	{
+		const int32 ControllerId = LocalPlayer->GetControllerId();
+		if(ControllerId == SessionOwnerId)
+		{
+			continue;
+		}
+		// Without an id of the online service (LAN, not logged in), there is nothing to register: the player is part
+		// of the game by traveling with the session owner. The host learns about the player when its child
+		// connection joins.
+		const FUniqueNetIdRepl UniqueId = LocalPlayer->GetPreferredUniqueNetId();
+		if(!UniqueId.IsValid())
+		{
+			SetLocalPlayerStage(ControllerId, ESessionStage::Joined);
+			continue;
+		}
+		SetLocalPlayerStage(ControllerId, ESessionStage::Joining);
+		SI->RegisterLocalPlayer
+			( *UniqueId
+			, NAME_GameSession
+			, FOnRegisterLocalPlayerCompleteDelegate::CreateWeakLambda(this, [this, ControllerId] (const FUniqueNetId&, EOnJoinSessionCompleteResult::Type Result)
+			{
+				SetLocalPlayerStage(ControllerId, Result == EOnJoinSessionCompleteResult::Success ? ESessionStage::Joined : ESessionStage::Failed);
+			})
+			);
+	}
+}
@@ -4,8 +4,37 @@
 #include "Modes/MyGameInstance.h"
 
 #include "OnlineSubsystemUtils.h"
+#include "Diagnostics/MyEventLog.h"
 #include "Modes/MyGISubsystem.h"
 #include "Modes/MyLocalPlayer.h"
+#include "Net/MyServerDrain.h"
+
+namespace
+{
+	FAutoConsoleCommandWithWorld SplitscreenAddCommand
+		( TEXT("mp.Splitscreen.Add")
+		, TEXT("Add a split-screen player on the next free controller (main menu only)")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyGameInstance* GI = World->GetGameInstance<UMyGameInstance>())
+			{
+				GI->AddSplitscreenPlayer();
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorld SplitscreenRemoveCommand
+		( TEXT("mp.Splitscreen.Remove")
+		, TEXT("Remove the split-screen player that was added last (main menu only)")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyGameInstance* GI = World->GetGameInstance<UMyGameInstance>())
+			{
+				GI->RemoveSplitscreenPlayer();
+			}
+		})
+		);
+}
 
 void UMyGameInstance::HostGame(const FLocalPlayerContext& LPC)
 {
@@ -24,9 +53,11 @@ void UMyGameInstance::HostGame(const FLocalPlayerContext& LPC)
 		//   variable in the game instance
 		, [this, LPC] (FName SessionName, bool bSuccess)
 		{
+			MP_EVENT(CreateSessionComplete, this, SessionName, bSuccess);
 			if(bSuccess)
 			{
-				Cast<UMyLocalPlayer>(LPC.GetLocalPlayer())->CurrentLevel = ECurrentLevel::SomeLevel;
+				// all split-screen players travel along
+				SetCurrentLevel(ECurrentLevel::SomeLevel);
 				GetWorld()->ServerTravel("/Game/SomeLevel?listen");
 			}
 			else
@@ -41,9 +72,13 @@ void UMyGameInstance::HostGame(const FLocalPlayerContext& LPC)
 
 void UMyGameInstance::JoinGame(const FLocalPlayerContext& LPC)
 {
-	Cast<UMyLocalPlayer>(LPC.GetLocalPlayer())->IsMultiplayer = true;
+	for(ULocalPlayer* LocalPlayer : GetLocalPlayers())
+	{
+		Cast<UMyLocalPlayer>(LocalPlayer)->IsMultiplayer = true;
+	}
 	GetSubsystem<UMyGISubsystem>()->JoinSession(LPC, [this, LPC] (ECurrentLevel NewLevel, EOnJoinSessionCompleteResult::Type Result)
 	{
+		MP_EVENT(JoinSessionComplete, this, Result, NewLevel);
 		switch(Result)
 		{
 		using namespace EOnJoinSessionCompleteResult;
@@ -65,8 +100,8 @@ void UMyGameInstance::JoinGame(const FLocalPlayerContext& LPC)
 		case Success:
 			if(ClientTravelToSession(LPC.GetLocalPlayer()->GetControllerId(), NAME_GameSession))
 			{
-				
-				Cast<UMyLocalPlayer>(LPC.GetLocalPlayer())->CurrentLevel = NewLevel;
+				// the other split-screen players join over the same connection, as child connections
+				SetCurrentLevel(NewLevel);
 			}
 			else
 			{
@@ -78,17 +113,61 @@ void UMyGameInstance::JoinGame(const FLocalPlayerContext& LPC)
 	});
 }
 
-void UMyGameInstance::MulticastRPC_LeaveSession_Implementation()
+void UMyGameInstance::LeaveSession()
 {
+	UWorld* World = GetWorld();
+	UMyServerDrain* Drain = World ? World->GetSubsystem<UMyServerDrain>() : nullptr;
+	if(Drain && World->GetNetMode() == NM_ListenServer && Drain->GetNumClients() > 0)
+	{
+		Drain->StartDrain();
+		return;
+	}
 	GetSubsystem<UMyGISubsystem>()->LeaveSession();
 }
 
+void UMyGameInstance::AddSplitscreenPlayer()
+{
+	UMyLocalPlayer* Primary = Cast<UMyLocalPlayer>(GetFirstGamePlayer());
+	if(!Primary || !Primary->GetIsInMainMenu() || GetNumLocalPlayers() >= MaxLocalPlayers)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: split-screen players join in the main menu, up to %d"), *GetFullName(), MaxLocalPlayers)
+		return;
+	}
+	FString Error;
+	// -1: the next free controller id; the player controller gets spawned right away
+	if(!CreateLocalPlayer(-1, Error, true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: couldn't add split-screen player: %s"), *GetFullName(), *Error)
+	}
+}
+
+void UMyGameInstance::RemoveSplitscreenPlayer()
+{
+	UMyLocalPlayer* Primary = Cast<UMyLocalPlayer>(GetFirstGamePlayer());
+	if(!Primary || !Primary->GetIsInMainMenu() || GetNumLocalPlayers() <= 1)
+	{
+		return;
+	}
+	RemoveLocalPlayer(GetLocalPlayerByIndex(GetNumLocalPlayers() - 1));
+}
+
+void UMyGameInstance::SetCurrentLevel(ECurrentLevel NewLevel)
+{
+	for(ULocalPlayer* LocalPlayer : GetLocalPlayers())
+	{
+		Cast<UMyLocalPlayer>(LocalPlayer)->CurrentLevel = NewLevel;
+	}
+}
+
 int32 UMyGameInstance::AddLocalPlayer(ULocalPlayer* NewPlayer, int32 ControllerId)
 {
 	int32 InsertIndex = Super::AddLocalPlayer(NewPlayer, ControllerId);
 	UMyLocalPlayer* LocalPlayer = Cast<UMyLocalPlayer>(NewPlayer);
-	LocalPlayer->CurrentLevel = ECurrentLevel::MainMenu;
-	LocalPlayer->IsMultiplayer = false;
+	// a split-screen player joins the others where they are
+	const UMyLocalPlayer* Primary = Cast<UMyLocalPlayer>(GetFirstGamePlayer());
+	const bool bJoinsPrimary = Primary && Primary != LocalPlayer;
+	LocalPlayer->CurrentLevel = bJoinsPrimary ? Primary->CurrentLevel : ECurrentLevel::MainMenu;
+	LocalPlayer->IsMultiplayer = bJoinsPrimary && Primary->IsMultiplayer;
 	LocalPlayer->ShowInGameMenu = false;
 
 	/*
@@ -3,21 +3,143 @@
 
 #include "Modes/MyGameModeBase.h"
 
+#include "TutorialMPBasics.h"
+#include "Diagnostics/MyEventLog.h"
+#include "Diagnostics/MyMemoryTags.h"
 #include "GameFramework/GameSession.h"
 #include "GameFramework/PlayerStart.h"
 #include "Kismet/GameplayStatics.h"
+#include "Lockstep/MyLockstepSubsystem.h"
 #include "Modes/MyPlayerController.h"
 #include "MyPawn/MyPawn.h"
+#include "Net/MyServerDrain.h"
+#include "Net/MyServerGovernor.h"
+#include "Net/MySessionAdvertiser.h"
 
 #define LOCTEXT_NAMESPACE "GameMode"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawn pool size"), STAT_PawnPoolSize, STATGROUP_TutorialMPBasics);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawn pool hits"), STAT_PawnPoolHits, STATGROUP_TutorialMPBasics);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawn pool misses"), STAT_PawnPoolMisses, STATGROUP_TutorialMPBasics);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last garbage collection (ms)"), STAT_LastGarbageCollectTime, STATGROUP_TutorialMPBasics);
+
+AMyPawn* AMyGameModeBase::AcquirePawn(UClass* PawnClass, const FTransform& SpawnTransform)
+{
+	// search from the back, such that `RemoveAtSwap` doesn't move anything in the common case
+	for(int32 i = PawnPool.Num() - 1; i >= 0; --i)
+	{
+		AMyPawn* Pawn = PawnPool[i];
+		if(IsValid(Pawn) && Pawn->GetClass() == PawnClass)
+		{
+			PawnPool.RemoveAtSwap(i);
+			Pawn->ActivateFromPool(SpawnTransform);
+			PawnPoolHits++;
+			INC_DWORD_STAT(STAT_PawnPoolHits);
+			SET_DWORD_STAT(STAT_PawnPoolSize, PawnPool.Num());
+			return Pawn;
+		}
+	}
+	PawnPoolMisses++;
+	INC_DWORD_STAT(STAT_PawnPoolMisses);
+	return nullptr;
+}
+
+void AMyGameModeBase::ReleasePawn(AMyPawn* Pawn)
+{
+	if(!IsValid(Pawn) || Pawn->IsPooled())
+	{
+		return;
+	}
+	Pawn->DeactivateToPool();
+	PawnPool.Add(Pawn);
+	SET_DWORD_STAT(STAT_PawnPoolSize, PawnPool.Num());
+}
+
+void AMyGameModeBase::BeginPlay()
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Pawns);
+	Super::BeginPlay();
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &AMyGameModeBase::HandlePreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &AMyGameModeBase::HandlePostGarbageCollect);
+
+	// in lockstep mode, the players don't get pawns, cf. `PlayerCanRestart_Implementation`
+	const UMyLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UMyLockstepSubsystem>();
+	if(Lockstep && Lockstep->IsLockstepHost())
+	{
+		return;
+	}
+
+	// pre-warm the pool: we pay for spawning the pawns once, when the level loads, instead of whenever a player joins
+	UClass* PawnClass = DefaultPawnClass;
+	if(!IsValid(PawnClass) || !PawnClass->IsChildOf<AMyPawn>())
+	{
+		MP_EVENT(PawnPoolNoMyPawn, this);
+		return;
+	}
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for(int32 i = 0; i < PawnPoolPrewarmCount; ++i)
+	{
+		AMyPawn* Pawn = GetWorld()->SpawnActor<AMyPawn>(PawnClass, FTransform::Identity, SpawnParameters);
+		ReleasePawn(Pawn);
+	}
+}
+
+void AMyGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	MP_EVENT
+		( PawnPoolStats
+		, this
+		, PawnPoolHits
+		, PawnPoolMisses
+		, PawnPool.Num()
+		, GarbageCollectCount
+		);
+	MP_EVENT(GarbageCollectTime, this, GarbageCollectTotalTime * 1000.);
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+void AMyGameModeBase::PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage)
+{
+	Super::PreLogin(Options, Address, UniqueId, ErrorMessage);
+
+	// a non-empty error message rejects the login, the client gets it as the reason
+	const UMyServerDrain* Drain = GetWorld()->GetSubsystem<UMyServerDrain>();
+	if(ErrorMessage.IsEmpty() && Drain && Drain->IsDraining())
+	{
+		ErrorMessage = TEXT("server is shutting down");
+	}
+}
+
 void AMyGameModeBase::PostLogin(APlayerController* NewPlayer)
 {
 	Super::PostLogin(NewPlayer);
 
+	// the connection replicates for the first time this very frame, don't wait for the next one
+	if(const UMyServerGovernor* Governor = GetWorld()->GetSubsystem<UMyServerGovernor>())
+	{
+		Governor->ClampConnection(NewPlayer->GetNetConnection());
+	}
+
+	if(UMySessionAdvertiser* Advertiser = GetWorld()->GetSubsystem<UMySessionAdvertiser>())
+	{
+		Advertiser->MarkDirty();
+	}
+
+	UMyLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UMyLockstepSubsystem>();
+	if(Lockstep && Lockstep->IsLockstepHost())
+	{
+		Lockstep->AddPlayer(Cast<AMyPlayerController>(NewPlayer));
+		return;
+	}
 	if(!IsValid(NewPlayer->GetPawn()))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("%s: No pawn spawned."), *GetFullName())
+		MP_EVENT(NoPawnSpawned, this, NewPlayer->GetFName());
 		// Unfortunately, `KickPlayer` causes a network failure with the client and I don't know how to
 		// respond to that properly. Therefore, we tell the client to quit themselves
 		//GameSession->KickPlayer(NewPlayer, LOCTEXT("CouldntSpawn", "Could not spawn pawn"));
@@ -25,14 +147,68 @@ void AMyGameModeBase::PostLogin(APlayerController* NewPlayer)
 	}
 }
 
+void AMyGameModeBase::Logout(AController* Exiting)
+{
+	if(UMySessionAdvertiser* Advertiser = GetWorld()->GetSubsystem<UMySessionAdvertiser>())
+	{
+		Advertiser->MarkDirty();
+	}
+	UMyLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UMyLockstepSubsystem>();
+	AMyPlayerController* PC = Cast<AMyPlayerController>(Exiting);
+	if(Lockstep && Lockstep->IsLockstepHost() && PC)
+	{
+		Lockstep->RemovePlayer(PC);
+	}
+	Super::Logout(Exiting);
+}
+
+bool AMyGameModeBase::PlayerCanRestart_Implementation(APlayerController* Player)
+{
+	const UMyLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UMyLockstepSubsystem>();
+	if(Lockstep && Lockstep->IsLockstepHost())
+	{
+		return false;
+	}
+	return Super::PlayerCanRestart_Implementation(Player);
+}
+
 AActor* AMyGameModeBase::ChoosePlayerStart_Implementation(AController* Player)
 {
 	// Don't call super, we implement our own independent method
 	//return Super::ChoosePlayerStart_Implementation(Player);
 	TArray<AActor*> Starts;
 	UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), Starts);
-	// simply fill the PlayerStarts in order
-	return Starts[GetNumPlayers() - 1];
+	if(Starts.IsEmpty())
+	{
+		return nullptr;
+	}
+	// simply fill the PlayerStarts in order; with more players than PlayerStarts (load tests), start over
+	return Starts[FMath::Max(GetNumPlayers() - 1, 0) % Starts.Num()];
+}
+
+APawn* AMyGameModeBase::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Pawns);
+	if(AMyPawn* Pawn = AcquirePawn(GetDefaultPawnClassForController(NewPlayer), SpawnTransform))
+	{
+		return Pawn;
+	}
+	// pool miss (or a pawn class that isn't pooled): spawn a new pawn the regular way;
+	// it will end up in the pool when its player leaves
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
+
+void AMyGameModeBase::HandlePreGarbageCollect()
+{
+	GarbageCollectStartTime = FPlatformTime::Seconds();
+}
+
+void AMyGameModeBase::HandlePostGarbageCollect()
+{
+	const double Duration = FPlatformTime::Seconds() - GarbageCollectStartTime;
+	GarbageCollectTotalTime += Duration;
+	GarbageCollectCount++;
+	SET_FLOAT_STAT(STAT_LastGarbageCollectTime, Duration * 1000.);
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -3,7 +3,9 @@
 
 #include "Modes/MyPlayerController.h"
 
+#include "Lockstep/MyLockstepSubsystem.h"
 #include "Modes/MyGameInstance.h"
+#include "Modes/MyGameModeBase.h"
 #include "Modes/MyGISubsystem.h"
 #include "MyPawn/MyPawn.h"
 
@@ -11,7 +13,7 @@ void AMyPlayerController::SetupInputComponent()
 {
 	Super::SetupInputComponent();
 
-	InputComponent->BindAction("ActionEscape", IE_Pressed, GetGameInstance<UMyGameInstance>(), &UMyGameInstance::MulticastRPC_LeaveSession);
+	InputComponent->BindAction("ActionEscape", IE_Pressed, GetGameInstance<UMyGameInstance>(), &UMyGameInstance::LeaveSession);
 
 	// `BindActionRPC` is a custom private function, see below.
 	// Usually you would see here: calls to `InputComponent->BindAction`.
@@ -22,24 +24,106 @@ void AMyPlayerController::SetupInputComponent()
 	BindActionWithRPC("ActionRight", IE_Pressed, EAction::Right);
 }
 
+void AMyPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if(IsLocalController() && FParse::Param(FCommandLine::Get(), TEXT("BotInput")))
+	{
+		GetWorldTimerManager().SetTimer(BotInputTimer, this, &AMyPlayerController::BotAction, 0.5f, true);
+	}
+}
+
 void AMyPlayerController::ClientRPC_LeaveSession_Implementation()
 {
 	GetGameInstance()->GetSubsystem<UMyGISubsystem>()->LeaveSession();
 }
 
+void AMyPlayerController::ClientRPC_ServerDraining_Implementation(float SecondsLeft)
+{
+	UE_LOG(LogNet, Display, TEXT("%s: host shutting down in %.0f s, leaving"), *GetFullName(), SecondsLeft)
+	// leaving right away spreads the disconnects as evenly as the host spreads the notices
+	GetGameInstance()->GetSubsystem<UMyGISubsystem>()->LeaveSession();
+}
+
+void AMyPlayerController::ClientRPC_LockstepSnapshot_Implementation(int32 TotalSize, const TArray<uint8>& Chunk)
+{
+	GetWorld()->GetSubsystem<UMyLockstepSubsystem>()->ReceiveSnapshot(TotalSize, Chunk);
+}
+
+void AMyPlayerController::ClientRPC_LockstepFrame_Implementation(const FLockstepFrame& Frame)
+{
+	GetWorld()->GetSubsystem<UMyLockstepSubsystem>()->ReceiveFrame(Frame);
+}
+
+void AMyPlayerController::ServerRPC_LockstepChecksum_Implementation(int32 Tick, uint32 Checksum)
+{
+	GetWorld()->GetSubsystem<UMyLockstepSubsystem>()->ReceiveChecksum(this, Tick, Checksum);
+}
+
+void AMyPlayerController::PerformAction(EAction Action)
+{
+	// same distinction as in `BindActionWithRPC`
+	if(GetLocalRole() == ROLE_Authority)
+	{
+		HandleAction(Action);
+	}
+	else
+	{
+		SendAction(Action);
+	}
+}
+
+double AMyPlayerController::ConsumeActionRoundTrip(int32 AcknowledgedAction)
+{
+	if(ActionSentTime < 0. || AcknowledgedAction < MeasuredAction)
+	{
+		return -1.;
+	}
+	const double RoundTrip = FPlatformTime::Seconds() - ActionSentTime;
+	ActionSentTime = -1.;
+	return RoundTrip;
+}
+
 void AMyPlayerController::HandleAction(EAction Action) const
 {
+	// in lockstep mode, there is no pawn to accelerate here, the action becomes part of the next frame
+	UMyLockstepSubsystem* Lockstep = GetWorld()->GetSubsystem<UMyLockstepSubsystem>();
+	if(Lockstep && Lockstep->IsLockstepHost())
+	{
+		Lockstep->SubmitAction(this, Action);
+		return;
+	}
+	AMyPawn* MyPawn = GetPawn<AMyPawn>();
+	// an RPC can arrive after the pawn is gone, e.g. when the player is leaving
+	if(!IsValid(MyPawn))
+	{
+		return;
+	}
 	switch(Action)
 	{
 	case EAction::Left:
-		GetPawn<AMyPawn>()->AccelerateLeft();
+		MyPawn->AccelerateLeft();
 		break;
 	case EAction::Right:
-		GetPawn<AMyPawn>()->AccelerateRight();
+		MyPawn->AccelerateRight();
 		break;
 	}
 }
 
+void AMyPlayerController::PawnLeavingGame()
+{
+	AMyPawn* MyPawn = GetPawn<AMyPawn>();
+	AMyGameModeBase* GameMode = GetWorld()->GetAuthGameMode<AMyGameModeBase>();
+	if(!IsValid(MyPawn) || !IsValid(GameMode))
+	{
+		Super::PawnLeavingGame();
+		return;
+	}
+	UnPossess();
+	GameMode->ReleasePawn(MyPawn);
+}
+
 void AMyPlayerController::BindActionWithRPC(const FName ActionName, EInputEvent KeyEvent, EAction Action)
 {
 	// We use a somewhat complicated way to bind actions.
@@ -69,13 +153,33 @@ void AMyPlayerController::BindActionWithRPC(const FName ActionName, EInputEvent
 		// into effect for the local client.
 		Binding.ActionDelegate.GetDelegateForManualSet().BindLambda([this, Action] ()
 		{
-			ServerRPC_HandleAction(Action);
+			SendAction(Action);
 		});
 	}
 	InputComponent->AddActionBinding(Binding);
 }
 
-void AMyPlayerController::ServerRPC_HandleAction_Implementation(EAction Action)
+void AMyPlayerController::ServerRPC_HandleAction_Implementation(EAction Action, int32 Sequence)
 {
 	HandleAction(Action);
+	if(AMyPawn* MyPawn = GetPawn<AMyPawn>())
+	{
+		MyPawn->AcknowledgeAction(Sequence);
+	}
+}
+
+void AMyPlayerController::SendAction(EAction Action)
+{
+	const int32 Sequence = NextAction++;
+	if(ActionSentTime < 0.)
+	{
+		ActionSentTime = FPlatformTime::Seconds();
+		MeasuredAction = Sequence;
+	}
+	ServerRPC_HandleAction(Action, Sequence);
+}
+
+void AMyPlayerController::BotAction()
+{
+	PerformAction(FMath::RandBool() ? EAction::Left : EAction::Right);
 }
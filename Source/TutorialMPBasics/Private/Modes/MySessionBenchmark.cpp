@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Modes/MySessionBenchmark.h"
+
+#include "Engine/LocalPlayer.h"
+#include "Modes/MyGameInstance.h"
+#include "Modes/MyLocalPlayer.h"
+
+namespace
+{
+	float Percentile(TArray<float> Samples, float P)
+	{
+		if(Samples.IsEmpty())
+		{
+			return 0.f;
+		}
+		Samples.Sort();
+		return Samples[FMath::Clamp(FMath::FloorToInt(P * Samples.Num()), 0, Samples.Num() - 1)];
+	}
+}
+
+bool UMySessionBenchmark::ShouldCreateSubsystem(UObject* Outer) const
+{
+	FString RoleName;
+	return Super::ShouldCreateSubsystem(Outer) && FParse::Value(FCommandLine::Get(), TEXT("SessionBench="), RoleName);
+}
+
+void UMySessionBenchmark::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FString RoleName;
+	FParse::Value(FCommandLine::Get(), TEXT("SessionBench="), RoleName);
+	Role = RoleName.Equals(TEXT("join"), ESearchCase::IgnoreCase) ? ERole::Join : ERole::Host;
+	FParse::Value(FCommandLine::Get(), TEXT("SessionBenchCycles="), Cycles);
+
+	// we need the session subsystem for the stages
+	UMyGISubsystem* GISub = Collection.InitializeDependency<UMyGISubsystem>();
+	SessionStageHandle = GISub->OnSessionStage.AddUObject(this, &UMySessionBenchmark::HandleSessionStage);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UMySessionBenchmark::HandlePostLoadMap);
+
+	UE_LOG(LogNet, Display, TEXT("%s: session benchmark, %s, %d cycles"), *GetFullName(), Role == ERole::Host ? TEXT("host") : TEXT("join"), Cycles)
+}
+
+void UMySessionBenchmark::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(PendingTicker);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	if(UMyGISubsystem* GISub = GetGameInstance()->GetSubsystem<UMyGISubsystem>())
+	{
+		GISub->OnSessionStage.Remove(SessionStageHandle);
+	}
+	Super::Deinitialize();
+}
+
+void UMySessionBenchmark::HandleSessionStage(ESessionStage Stage)
+{
+	switch(Stage)
+	{
+	case ESessionStage::Creating:
+		StartStage(TEXT("create"));
+		break;
+	case ESessionStage::Created:
+		EndStage(TEXT("create"));
+		StartStage(TEXT("travel"));
+		break;
+	case ESessionStage::Searching:
+		StartStage(TEXT("find"));
+		break;
+	case ESessionStage::Found:
+		EndStage(TEXT("find"));
+		break;
+	case ESessionStage::Joining:
+		StartStage(TEXT("join"));
+		break;
+	case ESessionStage::Joined:
+		EndStage(TEXT("join"));
+		StartStage(TEXT("travel"));
+		break;
+	case ESessionStage::Leaving:
+		StartStage(TEXT("leave"));
+		break;
+	case ESessionStage::Failed:
+		Failures++;
+		StageStartTimes.Reset();
+		RunAfter(RetrySeconds, [this] () { StartCycle(); });
+		break;
+	default: ;
+	}
+}
+
+void UMySessionBenchmark::HandlePostLoadMap(UWorld* World)
+{
+	// `ReturnToMainMenu` and a lost connection both end up in the default map
+	const bool bMainMenu = World->GetMapName().Contains(TEXT("MainMenu"));
+	if(!bMainMenu)
+	{
+		EndStage(TEXT("travel"));
+		RunAfter(Role == ERole::Host ? HostHoldSeconds : JoinHoldSeconds, [this] () { Leave(); });
+		return;
+	}
+	if(!bFirstMapLoaded)
+	{
+		bFirstMapLoaded = true;
+		RunAfter(RetrySeconds, [this] () { StartCycle(); });
+		return;
+	}
+
+	EndStage(TEXT("leave"));
+	// the player state isn't reset by `ReturnToMainMenu`
+	if(UMyLocalPlayer* LocalPlayer = Cast<UMyLocalPlayer>(GetGameInstance()->GetFirstGamePlayer()))
+	{
+		LocalPlayer->CurrentLevel = ECurrentLevel::MainMenu;
+		LocalPlayer->IsMultiplayer = false;
+	}
+
+	CompletedCycles++;
+	// the session has been left, nothing may listen to the session interface anymore
+	const int32 NumBound = GetGameInstance()->GetSubsystem<UMyGISubsystem>()->GetNumBoundSessionDelegates();
+	if(NumBound > 0)
+	{
+		UE_LOG(LogNet, Error, TEXT("%s: %d session delegates still bound after cycle %d"), *GetFullName(), NumBound, CompletedCycles)
+		bDelegatesLeaked = true;
+	}
+
+	if(CompletedCycles >= Cycles)
+	{
+		Finish();
+		return;
+	}
+	RunAfter(RetrySeconds, [this] () { StartCycle(); });
+}
+
+void UMySessionBenchmark::StartCycle()
+{
+	UMyGameInstance* GI = Cast<UMyGameInstance>(GetGameInstance());
+	const FLocalPlayerContext LPC(GI->GetFirstGamePlayer());
+	if(Role == ERole::Host)
+	{
+		GI->HostGame(LPC);
+	}
+	else
+	{
+		GI->JoinGame(LPC);
+	}
+}
+
+void UMySessionBenchmark::Leave()
+{
+	GetGameInstance()->GetSubsystem<UMyGISubsystem>()->LeaveSession();
+}
+
+void UMySessionBenchmark::Finish()
+{
+	bool bOverBudget = false;
+	UE_LOG(LogNet, Display, TEXT("SessionBench: %-8s %8s %10s %10s %10s %10s"), TEXT("stage"), TEXT("samples"), TEXT("p50 ms"), TEXT("p95 ms"), TEXT("p99 ms"), TEXT("budget"))
+	for(const TPair<FString, TArray<float>>& Stage : StageSamples)
+	{
+		const float P95 = Percentile(Stage.Value, .95f);
+		const FSessionStageBudget* Budget = Budgets.FindByPredicate([&Stage] (const FSessionStageBudget& B)
+		{
+			return B.Stage == Stage.Key;
+		});
+		const bool bExceeded = Budget && P95 > Budget->P95Ms;
+		bOverBudget |= bExceeded;
+		UE_LOG
+			( LogNet
+			, Display
+			, TEXT("SessionBench: %-8s %8d %10.1f %10.1f %10.1f %10s")
+			, *Stage.Key
+			, Stage.Value.Num()
+			, Percentile(Stage.Value, .5f)
+			, P95
+			, Percentile(Stage.Value, .99f)
+			, Budget ? *FString::Printf(TEXT("%.0f%s"), Budget->P95Ms, bExceeded ? TEXT(" EXCEEDED") : TEXT("")) : TEXT("-")
+			)
+	}
+	UE_LOG(LogNet, Display, TEXT("SessionBench: %d cycles, %d failures, delegates %s"), CompletedCycles, Failures, bDelegatesLeaked ? TEXT("LEAKED") : TEXT("ok"))
+
+	const bool bSuccess = !bOverBudget && !bDelegatesLeaked;
+	FPlatformMisc::RequestExitWithStatus(false, bSuccess ? 0 : 1);
+}
+
+void UMySessionBenchmark::RunAfter(float Delay, TFunction<void()> Function)
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(PendingTicker);
+	PendingTicker = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Function] (float)
+	{
+		Function();
+		// once
+		return false;
+	}), Delay);
+}
+
+void UMySessionBenchmark::StartStage(const FString& Stage)
+{
+	StageStartTimes.Add(Stage, FPlatformTime::Seconds());
+}
+
+void UMySessionBenchmark::EndStage(const FString& Stage)
+{
+	double StartTime;
+	if(StageStartTimes.RemoveAndCopyValue(Stage, StartTime))
+	{
+		StageSamples.FindOrAdd(Stage).Add((FPlatformTime::Seconds() - StartTime) * 1000.);
+	}
+}
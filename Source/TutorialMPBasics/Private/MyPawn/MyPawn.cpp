@@ -4,7 +4,42 @@
 #include "MyPawn/MyPawn.h"
 
 #include "Components/SphereComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "Modes/MyPlayerController.h"
+#include "MyPawn/MyPawnSubsystem.h"
+#include "Net/MyNetQualitySubsystem.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+static TAutoConsoleVariable<float> CVarServerStateInterval
+	( TEXT("mp.Pawn.ServerStateInterval")
+	, .5f
+	, TEXT("Seconds between two replications of the authoritative pawn location")
+	);
+
+static TAutoConsoleVariable<float> CVarCorrectionThreshold
+	( TEXT("mp.Pawn.CorrectionThreshold")
+	, 10.f
+	, TEXT("A client corrects the location of a pawn when it's off by more than this distance")
+	);
+
+static TAutoConsoleVariable<float> CVarPriorityDistance
+	( TEXT("mp.Pawn.PriorityDistance")
+	, 3000.f
+	, TEXT("Distance to the viewer at which a pawn's net priority is halved")
+	);
+
+static TAutoConsoleVariable<float> CVarPriorityChangeWindow
+	( TEXT("mp.Pawn.PriorityChangeWindow")
+	, 1.f
+	, TEXT("Seconds after a change of velocity during which a pawn gets a higher net priority")
+	);
+
+static TAutoConsoleVariable<float> CVarPriorityChangeBoost
+	( TEXT("mp.Pawn.PriorityChangeBoost")
+	, 4.f
+	, TEXT("Net priority factor of a pawn whose velocity just changed, fading to 1 over mp.Pawn.PriorityChangeWindow")
+	);
 
 // Sets default values
 AMyPawn::AMyPawn()
@@ -25,11 +60,105 @@ AMyPawn::AMyPawn()
 void AMyPawn::AccelerateLeft()
 {
 	Velocity += FVector(0, -10, 0);
+	MarkVelocityDirty();
 }
 
 void AMyPawn::AccelerateRight()
 {
 	Velocity += FVector(0, 10, 0);
+	MarkVelocityDirty();
+}
+
+void AMyPawn::SetVelocity(const FVector& NewVelocity)
+{
+	Velocity = NewVelocity;
+	MarkVelocityDirty();
+}
+
+void AMyPawn::AcknowledgeAction(int32 Sequence)
+{
+	LastAction = Sequence;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AMyPawn, LastAction, this);
+}
+
+void AMyPawn::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	bPooled = false;
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	// the pawn was irrelevant for all clients while pooled, don't wait for the next regular net update
+	ForceNetUpdate();
+	GetWorld()->GetSubsystem<UMyPawnSubsystem>()->RegisterPawn(this);
+}
+
+void AMyPawn::DeactivateToPool()
+{
+	bPooled = true;
+	// a pawn from the pool has to be indistinguishable from a freshly spawned one
+	Velocity = FVector::Zero();
+	MarkVelocityDirty();
+	// the sequence numbers of the next owner start over
+	AcknowledgeAction(INDEX_NONE);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetWorld()->GetSubsystem<UMyPawnSubsystem>()->UnregisterPawn(this);
+}
+
+void AMyPawn::MarkVelocityDirty()
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME(AMyPawn, Velocity, this);
+	VelocityChangeTime = GetWorld()->GetTimeSeconds();
+}
+
+float AMyPawn::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	// the viewer's own pawn always comes first
+	if(ViewTarget == this || (Viewer != nullptr && Viewer == GetController()))
+	{
+		return NetPriority * Time * 4.f;
+	}
+
+	// 1 right at the viewer, 1/2 at `mp.Pawn.PriorityDistance`, towards 0 beyond
+	const float RelativeDistance = FVector::Dist(ViewPos, GetActorLocation()) / FMath::Max(CVarPriorityDistance.GetValueOnGameThread(), 1.f);
+	const float DistanceFactor = FMath::Max(1.f / (1.f + RelativeDistance * RelativeDistance), .05f);
+
+	// `mp.Pawn.PriorityChangeBoost` right after a change of velocity, fading to 1
+	float ChangeFactor = 1.f;
+	if(VelocityChangeTime >= 0.f)
+	{
+		const float SinceChange = GetWorld()->GetTimeSeconds() - VelocityChangeTime;
+		const float Fade = 1.f - SinceChange / FMath::Max(CVarPriorityChangeWindow.GetValueOnGameThread(), KINDA_SMALL_NUMBER);
+		ChangeFactor += (CVarPriorityChangeBoost.GetValueOnGameThread() - 1.f) * FMath::Clamp(Fade, 0.f, 1.f);
+	}
+
+	return NetPriority * Time * DistanceFactor * ChangeFactor;
+}
+
+float AMyPawn::GetRadius() const
+{
+	return Root->GetScaledSphereRadius();
+}
+
+void AMyPawn::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if(!bPooled && bRegisterWithSubsystem)
+	{
+		GetWorld()->GetSubsystem<UMyPawnSubsystem>()->RegisterPawn(this);
+	}
+}
+
+void AMyPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(UMyPawnSubsystem* PawnSubsystem = GetWorld()->GetSubsystem<UMyPawnSubsystem>())
+	{
+		PawnSubsystem->UnregisterPawn(this);
+	}
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMyPawn::Tick(float DeltaTime)
@@ -38,10 +167,63 @@ void AMyPawn::Tick(float DeltaTime)
 
 	// move the pawn according to its velocity
 	SetActorLocation(GetActorLocation() + Velocity * DeltaTime);
+
+	if(HasAuthority())
+	{
+		ServerStateAge += DeltaTime;
+		if(ServerStateAge >= CVarServerStateInterval.GetValueOnGameThread())
+		{
+			ServerStateAge = 0.f;
+			ServerState.Location = GetActorLocation();
+			ServerState.ServerTime = GetWorld()->GetTimeSeconds();
+			MARK_PROPERTY_DIRTY_FROM_NAME(AMyPawn, ServerState, this);
+		}
+	}
+}
+
+void AMyPawn::OnRep_LastAction()
+{
+	// the round trip of an action: key press -> RPC -> velocity changes on the host -> replicated back to us
+	AMyPlayerController* PC = GetController<AMyPlayerController>();
+	if(IsValid(PC) && PC->IsLocalController())
+	{
+		const double InputLatency = PC->ConsumeActionRoundTrip(LastAction);
+		if(InputLatency >= 0.)
+		{
+			GetGameInstance()->GetSubsystem<UMyNetQualitySubsystem>()->RecordInputLatency(InputLatency);
+		}
+	}
+}
+
+void AMyPawn::OnRep_ServerState()
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if(!IsValid(GameState))
+	{
+		return;
+	}
+	// the host's location is from the past, extrapolate to now
+	const float Age = FMath::Max(GameState->GetServerWorldTimeSeconds() - ServerState.ServerTime, 0.f);
+	const FVector Expected = FVector(ServerState.Location) + Velocity * Age;
+	const float Error = FVector::Dist(Expected, GetActorLocation());
+	const bool bCorrect = Error > CVarCorrectionThreshold.GetValueOnGameThread();
+	if(bCorrect)
+	{
+		SetActorLocation(Expected);
+	}
+	GetGameInstance()->GetSubsystem<UMyNetQualitySubsystem>()->RecordPositionError(Error, bCorrect);
 }
 
 void AMyPawn::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(AMyPawn, Velocity);
+
+	// `Velocity` is push based: instead of comparing it every net update, the replication system (classic or Iris)
+	// only looks at it after `MARK_PROPERTY_DIRTY_FROM_NAME`. Thus, every write to `Velocity` has to mark it dirty.
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AMyPawn, Velocity, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AMyPawn, ServerState, Params);
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AMyPawn, LastAction, Params);
 }
\ No newline at end of file
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MyPawn/MyPawnInstanceRenderer.h"
+
+#include "TutorialMPBasics.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "MyPawn/MyPawn.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pawn instance update"), STAT_PawnInstanceUpdate, STATGROUP_TutorialMPBasics);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawn instances"), STAT_PawnInstances, STATGROUP_TutorialMPBasics);
+
+AMyPawnInstanceRenderer::AMyPawnInstanceRenderer()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	Instances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(FName(TEXT("Instances")));
+	SetRootComponent(Instances);
+	Instances->SetMobility(EComponentMobility::Movable);
+	// collisions are the business of the pawns' spheres
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetCanEverAffectNavigation(false);
+}
+
+void AMyPawnInstanceRenderer::AddPawn(AMyPawn* Pawn)
+{
+	UStaticMeshComponent* Body = Pawn->GetBody();
+	if(Pawn->InstanceIndex != INDEX_NONE || !IsValid(Body))
+	{
+		return;
+	}
+	// all pawns look the same, the first one decides
+	if(Instances->GetStaticMesh() == nullptr)
+	{
+		Instances->SetStaticMesh(Body->GetStaticMesh());
+		for(int32 i = 0; i < Body->GetNumMaterials(); ++i)
+		{
+			Instances->SetMaterial(i, Body->GetMaterial(i));
+		}
+	}
+	Pawn->InstanceIndex = Instances->AddInstance(Body->GetRelativeTransform() * Pawn->GetActorTransform(), true);
+	Owners.Add(Pawn);
+	check(Pawn->InstanceIndex == Owners.Num() - 1);
+	Body->UnregisterComponent();
+	INC_DWORD_STAT(STAT_PawnInstances);
+}
+
+void AMyPawnInstanceRenderer::RemovePawn(AMyPawn* Pawn)
+{
+	const int32 Index = Pawn->InstanceIndex;
+	if(!Owners.IsValidIndex(Index) || Owners[Index] != Pawn)
+	{
+		return;
+	}
+	// Removing an instance from the middle shifts all instances behind it; removing the last one doesn't. Thus the
+	// last pawn takes over the instance of the removed one, its transform gets fixed with the next batch update.
+	const int32 Last = Owners.Num() - 1;
+	Owners.RemoveAtSwap(Index);
+	if(Index != Last)
+	{
+		Owners[Index]->InstanceIndex = Index;
+	}
+	Instances->RemoveInstance(Last);
+	Pawn->InstanceIndex = INDEX_NONE;
+	if(IsValid(Pawn->GetBody()) && !Pawn->GetBody()->IsRegistered())
+	{
+		Pawn->GetBody()->RegisterComponent();
+	}
+	DEC_DWORD_STAT(STAT_PawnInstances);
+}
+
+void AMyPawnInstanceRenderer::RemoveAllPawns()
+{
+	while(!Owners.IsEmpty())
+	{
+		RemovePawn(Owners.Last());
+	}
+}
+
+void AMyPawnInstanceRenderer::UpdateInstances()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PawnInstanceUpdate);
+	if(Owners.IsEmpty())
+	{
+		return;
+	}
+	// computed from the actor transform, as the unregistered body doesn't necessarily follow its pawn anymore
+	Transforms.Reset(Owners.Num());
+	for(const AMyPawn* Pawn : Owners)
+	{
+		Transforms.Add(Pawn->GetBody()->GetRelativeTransform() * Pawn->GetActorTransform());
+	}
+	// pawns jump around (corrections, pooling), thus teleport: no motion blur between the old and the new transform
+	Instances->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+}
@@ -0,0 +1,588 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MyPawn/MyPawnSubsystem.h"
+
+#include "TutorialMPBasics.h"
+#include "Diagnostics/MyMemoryTags.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "MyPawn/MyPawn.h"
+#include "MyPawn/MyPawnInstanceRenderer.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pawn history record"), STAT_PawnHistoryRecord, STATGROUP_TutorialMPBasics);
+DECLARE_MEMORY_STAT(TEXT("Pawn history"), STAT_PawnHistoryMemory, STATGROUP_TutorialMPBasics);
+DECLARE_CYCLE_STAT(TEXT("Pawn collisions"), STAT_PawnCollisions, STATGROUP_TutorialMPBasics);
+
+static TAutoConsoleVariable<bool> CVarPawnCollisions
+	( TEXT("mp.Pawn.Collisions")
+	, true
+	, TEXT("Resolve pawn-pawn collisions after every frame")
+	);
+
+static TAutoConsoleVariable<bool> CVarInstancedRendering
+	( TEXT("mp.Pawn.InstancedRendering")
+	, false
+	, TEXT("Draw all pawn bodies with one instanced static mesh component instead of one component per pawn")
+	);
+
+namespace
+{
+	FAutoConsoleCommandWithWorld PawnHistoryCommand
+		( TEXT("mp.PawnHistory")
+		, TEXT("Log memory footprint and per-frame recording cost of the lag compensation history")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyPawnSubsystem* PawnSubsystem = World->GetSubsystem<UMyPawnSubsystem>())
+			{
+				PawnSubsystem->LogHistoryStats();
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorldAndArgs SpatialHashBenchCommand
+		( TEXT("mp.SpatialHashBench")
+		, TEXT("mp.SpatialHashBench <pawn count> [<pawn count> ...]: overlap queries of the spatial hash vs. the engine")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			if(UMyPawnSubsystem* PawnSubsystem = World->GetSubsystem<UMyPawnSubsystem>())
+			{
+				for(const FString& Arg : Args)
+				{
+					PawnSubsystem->RunSpatialHashBenchmark(FCString::Atoi(*Arg));
+				}
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorld PawnRenderingCommand
+		( TEXT("mp.PawnRendering")
+		, TEXT("Log how pawns are rendered: primitives with a scene proxy, instances, batch update time")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyPawnSubsystem* PawnSubsystem = World->GetSubsystem<UMyPawnSubsystem>())
+			{
+				PawnSubsystem->LogRenderStats();
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorldAndArgs PawnRenderBenchCommand
+		( TEXT("mp.PawnRenderBench")
+		, TEXT("mp.PawnRenderBench <pawn count> [<seconds>]: frame time and primitives with and without instanced pawn rendering")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			UMyPawnSubsystem* PawnSubsystem = World->GetSubsystem<UMyPawnSubsystem>();
+			if(PawnSubsystem && Args.Num() > 0)
+			{
+				PawnSubsystem->StartRenderBenchmark(FCString::Atoi(*Args[0]), Args.Num() > 1 ? FCString::Atof(*Args[1]) : 5.f);
+			}
+		})
+		);
+}
+
+void UMyPawnSubsystem::RegisterPawn(AMyPawn* Pawn)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Pawns);
+	if(Pawns.Contains(Pawn))
+	{
+		return;
+	}
+	Pawns.Add(Pawn);
+	if(InstanceRenderer)
+	{
+		InstanceRenderer->AddPawn(Pawn);
+	}
+	int32 Slot = INDEX_NONE;
+	if(History.IsValid())
+	{
+		Slot = History->AddPawn();
+		if(Slot == INDEX_NONE)
+		{
+			// once, a crowd of pawns would flood the log otherwise
+			if(!bWarnedHistoryFull)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s: more than %d pawns, no lag compensation for %s and any further pawns"), *GetFullName(), HistoryMaxPawns, *Pawn->GetFullName())
+				bWarnedHistoryFull = true;
+			}
+		}
+		else
+		{
+			SlotOwners[Slot] = Pawn;
+		}
+	}
+	PawnSlots.Add(Slot);
+}
+
+void UMyPawnSubsystem::UnregisterPawn(AMyPawn* Pawn)
+{
+	// first: the render benchmark hands unregistered pawns to the instance renderer, too
+	if(InstanceRenderer)
+	{
+		InstanceRenderer->RemovePawn(Pawn);
+	}
+	const int32 Index = Pawns.Find(Pawn);
+	if(Index == INDEX_NONE)
+	{
+		return;
+	}
+	const int32 HashIndex = SpatialHashPawns.Find(Pawn);
+	if(HashIndex != INDEX_NONE)
+	{
+		SpatialHashPawns[HashIndex] = nullptr;
+	}
+	const int32 Slot = PawnSlots[Index];
+	if(History.IsValid() && Slot != INDEX_NONE)
+	{
+		History->RemovePawn(Slot);
+		SlotOwners[Slot] = nullptr;
+	}
+	Pawns.RemoveAtSwap(Index);
+	PawnSlots.RemoveAtSwap(Index);
+}
+
+double UMyPawnSubsystem::GetRewindTime(const AController* Viewer) const
+{
+	const APlayerState* PlayerState = IsValid(Viewer) ? Viewer->GetPlayerState<APlayerState>() : nullptr;
+	// the ping of a player state is the round trip time
+	const double RoundTrip = IsValid(PlayerState) ? PlayerState->GetPingInMilliseconds() / 1000. : 0.;
+	return GetWorld()->GetTimeSeconds() - RoundTrip;
+}
+
+bool UMyPawnSubsystem::RewindPawn(const AMyPawn* Pawn, double Time, FVector& OutLocation, float& OutRadius) const
+{
+	const int32 Index = Pawns.Find(const_cast<AMyPawn*>(Pawn));
+	if(!History.IsValid() || Index == INDEX_NONE || PawnSlots[Index] == INDEX_NONE)
+	{
+		return false;
+	}
+	return History->Rewind(PawnSlots[Index], Time, OutLocation, OutRadius);
+}
+
+void UMyPawnSubsystem::RewindOverlap(const AController* Viewer, const FVector& Center, float Radius, TArray<AMyPawn*>& OutPawns) const
+{
+	if(!History.IsValid())
+	{
+		return;
+	}
+	TArray<int32> Slots;
+	History->RewindOverlap(GetRewindTime(Viewer), Center, Radius, Slots);
+	for(const int32 Slot : Slots)
+	{
+		OutPawns.Add(SlotOwners[Slot]);
+	}
+}
+
+void UMyPawnSubsystem::LogHistoryStats() const
+{
+	if(!History.IsValid())
+	{
+		UE_LOG(LogTemp, Display, TEXT("%s: no pawn history (not the host)"), *GetFullName())
+		return;
+	}
+	UE_LOG
+		( LogTemp
+		, Display
+		, TEXT("%s: pawn history: %d frames x %d pawns, %llu bytes, %.1f s back; %d pawns recorded in %.3f ms (max %.3f ms)")
+		, *GetFullName()
+		, HistoryFrames
+		, History->GetMaxPawns()
+		, static_cast<uint64>(History->GetAllocatedSize())
+		, GetWorld()->GetTimeSeconds() - History->GetOldestTime()
+		, Pawns.Num()
+		, LastRecordTime * 1000.
+		, MaxRecordTime * 1000.
+		)
+}
+
+void UMyPawnSubsystem::QueryOverlaps(const FVector& Center, float Radius, TArray<AMyPawn*>& OutPawns) const
+{
+	TArray<int32, TInlineAllocator<16>> Indices;
+	SpatialHash.QueryOverlaps(Center, Radius, Indices);
+	for(const int32 i : Indices)
+	{
+		// pawns may have been unregistered since the hash has been built
+		if(SpatialHashPawns[i])
+		{
+			OutPawns.Add(SpatialHashPawns[i]);
+		}
+	}
+}
+
+void UMyPawnSubsystem::RunSpatialHashBenchmark(int32 Count)
+{
+	UWorld* World = GetWorld();
+	const AGameModeBase* GameMode = World->GetAuthGameMode();
+	if(!IsValid(GameMode) || !IsValid(GameMode->DefaultPawnClass) || !GameMode->DefaultPawnClass->IsChildOf<AMyPawn>() || Count <= 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: spatial hash benchmark needs the host and a positive pawn count"), *GetFullName())
+		return;
+	}
+
+	// same density for every pawn count: about one pawn per 4 m x 4 m
+	const float Extent = FMath::Sqrt(static_cast<float>(Count)) * 200.f;
+	TArray<AMyPawn*> BenchPawns;
+	for(int32 i = 0; i < Count; ++i)
+	{
+		const FTransform Transform(FVector(FMath::FRandRange(-Extent, Extent), FMath::FRandRange(-Extent, Extent), 10000.f));
+		AMyPawn* Pawn = World->SpawnActorDeferred<AMyPawn>(GameMode->DefaultPawnClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if(IsValid(Pawn))
+		{
+			// only the host needs them, connected clients mustn't pay for the benchmark; and they stay out of
+			// collisions and history, both would move or record them and skew the numbers
+			Pawn->SetReplicates(false);
+			Pawn->bRegisterWithSubsystem = false;
+			Pawn->FinishSpawning(Transform);
+			BenchPawns.Add(Pawn);
+		}
+	}
+
+	// spatial hash: build plus one neighbor query per pawn, i.e. what `ResolveCollisions` does every frame; a hash
+	// of its own, the one of the registered pawns is left alone
+	double StartTime = FPlatformTime::Seconds();
+	TArray<FVector4f> BenchSpheres;
+	BenchSpheres.Reserve(BenchPawns.Num());
+	for(const AMyPawn* Pawn : BenchPawns)
+	{
+		BenchSpheres.Add(FVector4f(FVector3f(Pawn->GetActorLocation()), Pawn->GetRadius()));
+	}
+	FPawnSpatialHash BenchHash;
+	BenchHash.Build(BenchSpheres, SpatialHashCellSize);
+	int32 HashOverlaps = 0;
+	TArray<int32> Indices;
+	for(const FVector4f& S : BenchSpheres)
+	{
+		Indices.Reset();
+		BenchHash.QueryOverlaps(FVector(S.X, S.Y, S.Z), S.W, Indices);
+		HashOverlaps += Indices.Num();
+	}
+	const double HashTime = FPlatformTime::Seconds() - StartTime;
+
+	// engine: one sphere overlap query per pawn against the physics scene
+	StartTime = FPlatformTime::Seconds();
+	int32 EngineOverlaps = 0;
+	TArray<FOverlapResult> Overlaps;
+	for(const AMyPawn* Pawn : BenchPawns)
+	{
+		Overlaps.Reset();
+		World->OverlapMultiByObjectType
+			( Overlaps
+			, Pawn->GetActorLocation()
+			, FQuat::Identity
+			, FCollisionObjectQueryParams(FCollisionObjectQueryParams::AllDynamicObjects)
+			, FCollisionShape::MakeSphere(Pawn->GetRadius())
+			);
+		EngineOverlaps += Overlaps.Num();
+	}
+	const double EngineTime = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG
+		( LogTemp
+		, Display
+		, TEXT("SpatialHashBench: %d pawns: spatial hash %.3f ms (%.2f us per pawn, %d overlaps), engine %.3f ms (%.2f us per pawn, %d overlaps)")
+		, BenchPawns.Num()
+		, HashTime * 1000.
+		, HashTime * 1000000. / BenchPawns.Num()
+		, HashOverlaps
+		, EngineTime * 1000.
+		, EngineTime * 1000000. / BenchPawns.Num()
+		, EngineOverlaps
+		)
+
+	for(AMyPawn* Pawn : BenchPawns)
+	{
+		Pawn->Destroy();
+	}
+}
+
+void UMyPawnSubsystem::SetInstancedRendering(bool bEnable)
+{
+	if(bEnable == (InstanceRenderer != nullptr))
+	{
+		return;
+	}
+	if(bEnable)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags = RF_Transient;
+		InstanceRenderer = GetWorld()->SpawnActor<AMyPawnInstanceRenderer>(SpawnParameters);
+		for(AMyPawn* Pawn : Pawns)
+		{
+			InstanceRenderer->AddPawn(Pawn);
+		}
+	}
+	else
+	{
+		InstanceRenderer->RemoveAllPawns();
+		InstanceRenderer->Destroy();
+		InstanceRenderer = nullptr;
+	}
+}
+
+int32 UMyPawnSubsystem::CountScenePrimitives() const
+{
+	int32 Count = 0;
+	for(TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		It->ForEachComponent<UPrimitiveComponent>(false, [&Count] (const UPrimitiveComponent* Component)
+		{
+			if(Component->IsRenderStateCreated())
+			{
+				++Count;
+			}
+		});
+	}
+	return Count;
+}
+
+void UMyPawnSubsystem::LogRenderStats() const
+{
+	UE_LOG
+		( LogTemp
+		, Display
+		, TEXT("%s: %d pawns, %s rendering, %d instances; %d primitives with a scene proxy in this world; last batch update %.3f ms")
+		, *GetFullName()
+		, Pawns.Num()
+		, InstanceRenderer ? TEXT("instanced") : TEXT("per component")
+		, InstanceRenderer ? InstanceRenderer->GetNumInstances() : 0
+		, CountScenePrimitives()
+		, LastInstanceUpdateTime * 1000.
+		)
+}
+
+void UMyPawnSubsystem::StartRenderBenchmark(int32 Count, float Seconds)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Pawns);
+	UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	// the game mode only exists on the host, but its defaults are known to clients, too
+	const AGameModeBase* GameModeDefaults = IsValid(GameState) ? GameState->GetDefaultGameMode() : nullptr;
+	if(RenderBenchmark.IsValid() || !GameModeDefaults || !IsValid(GameModeDefaults->DefaultPawnClass)
+		|| !GameModeDefaults->DefaultPawnClass->IsChildOf<AMyPawn>() || Count <= 0 || Seconds <= 0.f)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: render benchmark needs a MyPawn default pawn class, a positive pawn count and duration and no other run in progress"), *GetFullName())
+		return;
+	}
+
+	RenderBenchmark = MakeUnique<FRenderBenchmark>();
+	RenderBenchmark->Seconds = Seconds;
+	// local pawns, spread out (no collisions) and moving by their own tick, thus every one of them needs a new
+	// transform every frame; not replicated: on the host, they would otherwise be sent to every client and skew the
+	// clients' numbers; not registered: no collisions and history, the instance renderer gets them from us
+	const float Extent = FMath::Sqrt(static_cast<float>(Count)) * 300.f;
+	for(int32 i = 0; i < Count; ++i)
+	{
+		const FTransform Transform(FVector(FMath::FRandRange(-Extent, Extent), FMath::FRandRange(-Extent, Extent), 10000.f));
+		AMyPawn* Pawn = World->SpawnActorDeferred<AMyPawn>(GameModeDefaults->DefaultPawnClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if(IsValid(Pawn))
+		{
+			Pawn->SetReplicates(false);
+			Pawn->bRegisterWithSubsystem = false;
+			Pawn->FinishSpawning(Transform);
+			Pawn->SetVelocity(FVector(0., FMath::FRandRange(-100., 100.), 0.));
+			RenderBenchmark->Pawns.Add(Pawn);
+		}
+	}
+	SetInstancedRendering(false);
+	RenderBenchmark->RunEndTime = FPlatformTime::Seconds() + Seconds;
+}
+
+void UMyPawnSubsystem::TickRenderBenchmark()
+{
+	FRenderBenchmark& Bench = *RenderBenchmark;
+	// game thread work of the last frame, i.e. without waiting for the frame rate limit
+	Bench.FrameTime += FApp::GetDeltaTime() - FApp::GetIdleTime();
+	Bench.UpdateTime += LastInstanceUpdateTime;
+	++Bench.Frames;
+	if(FPlatformTime::Seconds() < Bench.RunEndTime)
+	{
+		return;
+	}
+
+	Bench.Results[Bench.Run] = FString::Printf
+		( TEXT("%s: %d primitives, frame %.3f ms, batch update %.3f ms")
+		, Bench.Run == 0 ? TEXT("per component") : TEXT("instanced")
+		, CountScenePrimitives()
+		, Bench.FrameTime * 1000. / Bench.Frames
+		, Bench.UpdateTime * 1000. / Bench.Frames
+		);
+	Bench.Frames = 0;
+	Bench.FrameTime = 0.;
+	Bench.UpdateTime = 0.;
+	if(++Bench.Run < 2)
+	{
+		SetInstancedRendering(true);
+		for(const TWeakObjectPtr<AMyPawn>& Pawn : Bench.Pawns)
+		{
+			if(Pawn.IsValid())
+			{
+				InstanceRenderer->AddPawn(Pawn.Get());
+			}
+		}
+		Bench.RunEndTime = FPlatformTime::Seconds() + Bench.Seconds;
+		return;
+	}
+
+	UE_LOG
+		( LogTemp
+		, Display
+		, TEXT("PawnRenderBench: %d pawns: %s; %s")
+		, Bench.Pawns.Num()
+		, *Bench.Results[0]
+		, *Bench.Results[1]
+		)
+	for(const TWeakObjectPtr<AMyPawn>& Pawn : Bench.Pawns)
+	{
+		if(Pawn.IsValid())
+		{
+			Pawn->Destroy();
+		}
+	}
+	RenderBenchmark.Reset();
+}
+
+bool UMyPawnSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && Cast<UWorld>(Outer)->IsGameWorld();
+}
+
+void UMyPawnSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Pawns);
+	Super::OnWorldBeginPlay(InWorld);
+
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMyPawnSubsystem::HandleWorldPostActorTick);
+
+	if(InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+	History = MakeUnique<FPawnHistory>(HistoryFrames, HistoryMaxPawns);
+	SlotOwners.Init(nullptr, History->GetMaxPawns());
+	SET_MEMORY_STAT(STAT_PawnHistoryMemory, History->GetAllocatedSize());
+
+	// pawns that began play before us
+	for(int32 i = 0; i < Pawns.Num(); ++i)
+	{
+		PawnSlots[i] = History->AddPawn();
+		if(PawnSlots[i] != INDEX_NONE)
+		{
+			SlotOwners[PawnSlots[i]] = Pawns[i];
+		}
+	}
+}
+
+void UMyPawnSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	RenderBenchmark.Reset();
+	InstanceRenderer = nullptr;
+	History.Reset();
+	SET_MEMORY_STAT(STAT_PawnHistoryMemory, 0);
+	Super::Deinitialize();
+}
+
+void UMyPawnSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Pawns);
+	if(World != GetWorld())
+	{
+		return;
+	}
+	if(CVarPawnCollisions.GetValueOnGameThread())
+	{
+		ResolveCollisions();
+	}
+
+	// rendering, not on a dedicated server; the benchmark switches back and forth by itself
+	if(RenderBenchmark.IsValid())
+	{
+		TickRenderBenchmark();
+	}
+	else
+	{
+		SetInstancedRendering(CVarInstancedRendering.GetValueOnGameThread() && World->GetNetMode() != NM_DedicatedServer);
+	}
+	if(InstanceRenderer)
+	{
+		const double UpdateStartTime = FPlatformTime::Seconds();
+		InstanceRenderer->UpdateInstances();
+		LastInstanceUpdateTime = FPlatformTime::Seconds() - UpdateStartTime;
+	}
+	else
+	{
+		LastInstanceUpdateTime = 0.;
+	}
+
+	if(!History.IsValid())
+	{
+		return;
+	}
+	SCOPE_CYCLE_COUNTER(STAT_PawnHistoryRecord);
+	const double StartTime = FPlatformTime::Seconds();
+
+	History->BeginFrame(World->GetTimeSeconds());
+	for(int32 i = 0; i < Pawns.Num(); ++i)
+	{
+		if(PawnSlots[i] != INDEX_NONE)
+		{
+			History->Record(PawnSlots[i], Pawns[i]->GetActorLocation(), Pawns[i]->GetRadius());
+		}
+	}
+
+	LastRecordTime = FPlatformTime::Seconds() - StartTime;
+	MaxRecordTime = FMath::Max(MaxRecordTime, LastRecordTime);
+}
+
+void UMyPawnSubsystem::BuildSpatialHash()
+{
+	Spheres.Reset(Pawns.Num());
+	SpatialHashPawns.Reset(Pawns.Num());
+	for(AMyPawn* Pawn : Pawns)
+	{
+		Spheres.Add(FVector4f(FVector3f(Pawn->GetActorLocation()), Pawn->GetRadius()));
+		SpatialHashPawns.Add(Pawn);
+	}
+	SpatialHash.Build(Spheres, SpatialHashCellSize);
+}
+
+void UMyPawnSubsystem::ResolveCollisions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PawnCollisions);
+
+	BuildSpatialHash();
+	const bool bAuthority = GetWorld()->GetNetMode() != NM_Client;
+	SpatialHash.ForEachOverlappingPair([this, bAuthority] (int32 i, int32 j)
+	{
+		AMyPawn* A = Pawns[i];
+		AMyPawn* B = Pawns[j];
+		const FVector Delta = B->GetActorLocation() - A->GetActorLocation();
+		const double Distance = Delta.Size();
+		const double Penetration = A->GetRadius() + B->GetRadius() - Distance;
+		if(Penetration <= 0.)
+		{
+			// already pushed apart by an earlier pair
+			return;
+		}
+		// pawns move in the Y direction only, thus pawns on top of each other get separated along Y
+		const FVector Normal = Distance > KINDA_SMALL_NUMBER ? Delta / Distance : FVector(0, 1, 0);
+
+		// both pawns give way by half the penetration; this happens on clients, too, such that they don't have to
+		// wait for the next correction by the host
+		A->AddActorWorldOffset(-Normal * (Penetration / 2.));
+		B->AddActorWorldOffset(Normal * (Penetration / 2.));
+
+		// velocity is replicated, the host alone decides: elastic collision of equal masses, i.e. the pawns swap
+		// the velocity components along the normal, if they are approaching each other
+		const double Approach = (B->Velocity - A->Velocity) | Normal;
+		if(bAuthority && Approach < 0.)
+		{
+			A->SetVelocity(A->Velocity + Normal * Approach);
+			B->SetVelocity(B->Velocity - Normal * Approach);
+		}
+	});
+}
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MyPawn/PawnHistory.h"
+
+namespace
+{
+	const FVector4f InvalidSample(0.f, 0.f, 0.f, -1.f);
+}
+
+FPawnHistory::FPawnHistory(int32 InNumFrames, int32 InMaxPawns)
+	: NumFrames(FMath::Max(InNumFrames, 2))
+	, MaxPawns(FMath::Max(InMaxPawns, 1))
+{
+	Samples.Init(InvalidSample, NumFrames * MaxPawns);
+	FrameTimes.Init(0., NumFrames);
+	// hand out low slots first, that keeps the used part of a row compact
+	FreeSlots.Reserve(MaxPawns);
+	for(int32 Slot = MaxPawns - 1; Slot >= 0; --Slot)
+	{
+		FreeSlots.Add(Slot);
+	}
+}
+
+int32 FPawnHistory::AddPawn()
+{
+	return FreeSlots.IsEmpty() ? INDEX_NONE : FreeSlots.Pop(false);
+}
+
+void FPawnHistory::RemovePawn(int32 Slot)
+{
+	check(Slot >= 0 && Slot < MaxPawns);
+	for(int32 Row = 0; Row < NumFrames; ++Row)
+	{
+		Samples[Row * MaxPawns + Slot] = InvalidSample;
+	}
+	FreeSlots.Add(Slot);
+}
+
+void FPawnHistory::BeginFrame(double Time)
+{
+	Head = (Head + 1) % NumFrames;
+	NumRecorded = FMath::Min(NumRecorded + 1, NumFrames);
+	FrameTimes[Head] = Time;
+	FVector4f* Row = &Samples[Head * MaxPawns];
+	for(int32 Slot = 0; Slot < MaxPawns; ++Slot)
+	{
+		Row[Slot] = InvalidSample;
+	}
+}
+
+void FPawnHistory::Record(int32 Slot, const FVector& Location, float Radius)
+{
+	check(Head != INDEX_NONE && Slot >= 0 && Slot < MaxPawns);
+	Samples[Head * MaxPawns + Slot] = FVector4f(FVector3f(Location), Radius);
+}
+
+bool FPawnHistory::Rewind(int32 Slot, double Time, FVector& OutLocation, float& OutRadius) const
+{
+	int32 Older, Newer;
+	float Alpha;
+	if(!FindRows(Time, Older, Newer, Alpha))
+	{
+		return false;
+	}
+	const FVector4f& A = Sample(Older, Slot);
+	const FVector4f& B = Sample(Newer, Slot);
+	if(!IsValid(A) && !IsValid(B))
+	{
+		return false;
+	}
+	// the pawn appeared or disappeared in between: no interpolation, take what's there
+	const FVector4f Result = !IsValid(A) ? B : !IsValid(B) ? A : FMath::Lerp(A, B, Alpha);
+	OutLocation = FVector(Result.X, Result.Y, Result.Z);
+	OutRadius = Result.W;
+	return true;
+}
+
+void FPawnHistory::RewindOverlap(double Time, const FVector& Center, float Radius, TArray<int32>& OutSlots) const
+{
+	int32 Older, Newer;
+	float Alpha;
+	if(!FindRows(Time, Older, Newer, Alpha))
+	{
+		return;
+	}
+	const FVector4f* RowA = &Samples[Older * MaxPawns];
+	const FVector4f* RowB = &Samples[Newer * MaxPawns];
+	const FVector3f C(Center);
+	for(int32 Slot = 0; Slot < MaxPawns; ++Slot)
+	{
+		const FVector4f& A = RowA[Slot];
+		const FVector4f& B = RowB[Slot];
+		if(!IsValid(A) && !IsValid(B))
+		{
+			continue;
+		}
+		const FVector4f S = !IsValid(A) ? B : !IsValid(B) ? A : FMath::Lerp(A, B, Alpha);
+		const float R = S.W + Radius;
+		if(FVector3f::DistSquared(FVector3f(S.X, S.Y, S.Z), C) <= R * R)
+		{
+			OutSlots.Add(Slot);
+		}
+	}
+}
+
+double FPawnHistory::GetOldestTime() const
+{
+	return NumRecorded == 0 ? 0. : FrameTimes[(Head - NumRecorded + 1 + NumFrames) % NumFrames];
+}
+
+SIZE_T FPawnHistory::GetAllocatedSize() const
+{
+	return Samples.GetAllocatedSize() + FrameTimes.GetAllocatedSize() + FreeSlots.GetAllocatedSize();
+}
+
+bool FPawnHistory::FindRows(double Time, int32& Older, int32& Newer, float& Alpha) const
+{
+	if(NumRecorded == 0)
+	{
+		return false;
+	}
+	// walk back from the newest row; the rows are few and walking them is cheaper than any search structure
+	Newer = Head;
+	for(int32 i = 1; i < NumRecorded; ++i)
+	{
+		Older = (Head - i + NumFrames) % NumFrames;
+		if(FrameTimes[Older] <= Time)
+		{
+			const double Span = FrameTimes[Newer] - FrameTimes[Older];
+			Alpha = Span > 0. ? FMath::Clamp(static_cast<float>((Time - FrameTimes[Older]) / Span), 0.f, 1.f) : 1.f;
+			return true;
+		}
+		Newer = Older;
+	}
+	// older than anything recorded: clamp to the oldest row
+	Older = Newer;
+	Alpha = 0.f;
+	return true;
+}
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MyPawn/PawnSpatialHash.h"
+
+void FPawnSpatialHash::Build(TArrayView<const FVector4f> InSpheres, float CellSize)
+{
+	Spheres.Reset();
+	Spheres.Append(InSpheres.GetData(), InSpheres.Num());
+
+	if(CellSize <= 0.f)
+	{
+		float MaxRadius = 1.f;
+		for(const FVector4f& S : Spheres)
+		{
+			MaxRadius = FMath::Max(MaxRadius, S.W);
+		}
+		CellSize = 2.f * MaxRadius;
+	}
+	InvCellSize = 1.f / CellSize;
+
+	// about two buckets per sphere keeps the chains short
+	Buckets.Init(INDEX_NONE, FMath::RoundUpToPowerOfTwo(FMath::Max(2 * Spheres.Num(), 16)));
+	Next.SetNumUninitialized(Spheres.Num(), false);
+	Cells.SetNumUninitialized(Spheres.Num(), false);
+	for(int32 i = 0; i < Spheres.Num(); ++i)
+	{
+		Cells[i] = ToCell(FVector3f(Spheres[i]));
+		int32& Head = Buckets[Bucket(Cells[i])];
+		Next[i] = Head;
+		Head = i;
+	}
+}
+
+SIZE_T FPawnSpatialHash::GetAllocatedSize() const
+{
+	return Spheres.GetAllocatedSize() + Cells.GetAllocatedSize() + Buckets.GetAllocatedSize() + Next.GetAllocatedSize();
+}
@@ -0,0 +1,301 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/MyNetQualitySubsystem.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Modes/MyPlayerController.h"
+#include "Net/MyServerGovernor.h"
+
+namespace
+{
+	float Percentile(TArray<float> Samples, float P)
+	{
+		if(Samples.IsEmpty())
+		{
+			return 0.f;
+		}
+		Samples.Sort();
+		return Samples[FMath::Clamp(FMath::FloorToInt(P * Samples.Num()), 0, Samples.Num() - 1)];
+	}
+
+	float Average(const TArray<float>& Samples)
+	{
+		float Sum = 0.f;
+		for(const float Sample : Samples)
+		{
+			Sum += Sample;
+		}
+		return Samples.IsEmpty() ? 0.f : Sum / Samples.Num();
+	}
+
+	UMyNetQualitySubsystem* GetNetQuality(const UWorld* World)
+	{
+		return World && World->GetGameInstance()
+			? World->GetGameInstance()->GetSubsystem<UMyNetQualitySubsystem>()
+			: nullptr;
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs NetProfileCommand
+		( TEXT("mp.NetProfile")
+		, TEXT("mp.NetProfile <Name>: apply the network emulation profile [PacketSimulationProfile.<Name>], or Off")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			if(UMyNetQualitySubsystem* NetQuality = GetNetQuality(World))
+			{
+				NetQuality->ApplyNetProfile(Args.IsEmpty() ? TEXT("Off") : Args[0]);
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorldAndArgs NetQualityMatrixCommand
+		( TEXT("mp.NetQualityMatrix")
+		, TEXT("mp.NetQualityMatrix [seconds per profile]: measure netcode quality under every emulation profile")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			if(UMyNetQualitySubsystem* NetQuality = GetNetQuality(World))
+			{
+				NetQuality->StartQualityMatrix(Args.IsEmpty() ? 0.f : FCString::Atof(*Args[0]));
+			}
+		})
+		);
+}
+
+void UMyNetQualitySubsystem::ApplyNetProfile(const FString& ProfileName)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	if(ProfileName.Equals(TEXT("Off"), ESearchCase::IgnoreCase))
+	{
+		GEngine->Exec(World, TEXT("NetEmulation.Off"));
+		CurrentProfile = TEXT("Off");
+		MaxBytesPerSecond = 0;
+		RestoreNetSpeed();
+		return;
+	}
+
+	const FString Section = FString::Printf(TEXT("PacketSimulationProfile.%s"), *ProfileName);
+	if(!GConfig->DoesSectionExist(*Section, GEngineIni))
+	{
+		UE_LOG(LogNet, Error, TEXT("%s: no network emulation profile %s"), *GetFullName(), *ProfileName)
+		return;
+	}
+	// latency, jitter and loss: the engine reads the very same section
+	GEngine->Exec(World, *FString::Printf(TEXT("NetEmulation.PktEmulationProfile %s"), *ProfileName));
+	
+	// bandwidth
+	MaxBytesPerSecond = 0;
+	GConfig->GetInt(*Section, TEXT("MaxBytesPerSecond"), MaxBytesPerSecond, GEngineIni);
+	CurrentProfile = ProfileName;
+	if(MaxBytesPerSecond > 0)
+	{
+		ApplyNetSpeed();
+	}
+	else
+	{
+		RestoreNetSpeed();
+	}
+	
+	UE_LOG(LogNet, Display, TEXT("%s: network emulation profile %s"), *GetFullName(), *ProfileName)
+}
+
+void UMyNetQualitySubsystem::StartQualityMatrix(float SecondsPerProfile)
+{
+	if(MatrixProfiles.IsEmpty())
+	{
+		UE_LOG(LogNet, Error, TEXT("%s: MatrixProfiles empty"), *GetFullName())
+		return;
+	}
+	bMatrixRunning = true;
+	MatrixIndex = 0;
+	MatrixProfileSeconds = SecondsPerProfile > 0.f ? SecondsPerProfile : MatrixSecondsPerProfile;
+	Matrix.Reset();
+	StartMatrixProfile();
+}
+
+void UMyNetQualitySubsystem::RecordPositionError(float Error, bool bCorrected)
+{
+	Current.PositionErrors.Add(Error);
+	Current.Corrections += bCorrected ? 1 : 0;
+}
+
+void UMyNetQualitySubsystem::RecordInputLatency(double Seconds)
+{
+	Current.InputLatencies.Add(Seconds * 1000.);
+}
+
+void UMyNetQualitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMyNetQualitySubsystem::Tick));
+
+	FString ProfileName;
+	if(FParse::Value(FCommandLine::Get(), TEXT("NetProfile="), ProfileName))
+	{
+		ApplyNetProfile(ProfileName);
+	}
+	if(FParse::Param(FCommandLine::Get(), TEXT("NetQualityMatrix")))
+	{
+		// starts as soon as we are connected, cf. `Tick`
+		bMatrixRunning = true;
+		bQuitAfterMatrix = true;
+		MatrixIndex = -1;
+		MatrixProfileSeconds = MatrixSecondsPerProfile;
+	}
+}
+
+void UMyNetQualitySubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	Super::Deinitialize();
+}
+
+bool UMyNetQualitySubsystem::Tick(float DeltaTime)
+{
+	ApplyNetSpeed();
+
+	if(!bMatrixRunning)
+	{
+		return true;
+	}
+	const UWorld* World = GetGameInstance()->GetWorld();
+	AMyPlayerController* PC = World ? Cast<AMyPlayerController>(GetGameInstance()->GetFirstLocalPlayerController(World)) : nullptr;
+	if(!IsValid(PC) || !IsValid(PC->GetPawn()) || World->GetNetMode() != NM_Client)
+	{
+		// not connected (yet)
+		return true;
+	}
+	if(MatrixIndex < 0)
+	{
+		MatrixIndex = 0;
+		StartMatrixProfile();
+	}
+
+	// keep the pawn busy, such that there is something to measure
+	MatrixActionCooldown -= DeltaTime;
+	if(MatrixActionCooldown <= 0.f)
+	{
+		MatrixActionCooldown = FMath::FRandRange(.2f, .6f);
+		PC->PerformAction(FMath::RandBool() ? EAction::Left : EAction::Right);
+	}
+
+	MatrixProfileRemaining -= DeltaTime;
+	if(MatrixProfileRemaining <= 0.f)
+	{
+		FinishMatrixProfile();
+	}
+	return true;
+}
+
+void UMyNetQualitySubsystem::ApplyNetSpeed()
+{
+	if(MaxBytesPerSecond <= 0)
+	{
+		return;
+	}
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	if(!NetDriver)
+	{
+		return;
+	}
+	// host: limits what gets sent to every client, within the cap of the governor; client: limits what we send to
+	// the host
+	const UMyServerGovernor* Governor = World->GetSubsystem<UMyServerGovernor>();
+	const int32 HostNetSpeed = Governor ? Governor->ClampNetSpeed(MaxBytesPerSecond) : MaxBytesPerSecond;
+	for(UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if(!SavedNetSpeeds.Contains(Connection))
+		{
+			SavedNetSpeeds.Add(Connection, Connection->CurrentNetSpeed);
+		}
+		Connection->CurrentNetSpeed = HostNetSpeed;
+	}
+	if(NetDriver->ServerConnection && NetDriver->ServerConnection->CurrentNetSpeed != MaxBytesPerSecond)
+	{
+		if(!SavedNetSpeeds.Contains(NetDriver->ServerConnection))
+		{
+			SavedNetSpeeds.Add(NetDriver->ServerConnection, NetDriver->ServerConnection->CurrentNetSpeed);
+		}
+		NetDriver->ServerConnection->CurrentNetSpeed = MaxBytesPerSecond;
+		// the host needs to know, too, as it limits what it sends to us; the console command `netspeed` tells it
+		if(APlayerController* PC = GetGameInstance()->GetFirstLocalPlayerController(World))
+		{
+			PC->ConsoleCommand(FString::Printf(TEXT("netspeed %d"), MaxBytesPerSecond));
+		}
+	}
+}
+
+void UMyNetQualitySubsystem::RestoreNetSpeed()
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	for(const TPair<TWeakObjectPtr<UNetConnection>, int32>& Saved : SavedNetSpeeds)
+	{
+		UNetConnection* Connection = Saved.Key.Get();
+		if(!Connection)
+		{
+			// closed meanwhile
+			continue;
+		}
+		// host: the governor keeps capping it, cf. `UMyServerGovernor::ClampConnection`
+		Connection->CurrentNetSpeed = Saved.Value;
+		if(NetDriver && Connection == NetDriver->ServerConnection)
+		{
+			// as in `ApplyNetSpeed`: the host limits what it sends to us
+			if(APlayerController* PC = GetGameInstance()->GetFirstLocalPlayerController(World))
+			{
+				PC->ConsoleCommand(FString::Printf(TEXT("netspeed %d"), Saved.Value));
+			}
+		}
+	}
+	SavedNetSpeeds.Reset();
+}
+
+void UMyNetQualitySubsystem::StartMatrixProfile()
+{
+	ApplyNetProfile(MatrixProfiles[MatrixIndex]);
+	Current = FMatrixRow();
+	Current.Profile = MatrixProfiles[MatrixIndex];
+	MatrixProfileRemaining = MatrixProfileSeconds;
+}
+
+void UMyNetQualitySubsystem::FinishMatrixProfile()
+{
+	Matrix.Add(MoveTemp(Current));
+	Current = FMatrixRow();
+	MatrixIndex++;
+	if(MatrixProfiles.IsValidIndex(MatrixIndex))
+	{
+		StartMatrixProfile();
+		return;
+	}
+	bMatrixRunning = false;
+	ApplyNetProfile(TEXT("Off"));
+	LogMatrix();
+	if(bQuitAfterMatrix)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UMyNetQualitySubsystem::LogMatrix() const
+{
+	UE_LOG(LogNet, Display, TEXT("NetQuality: %-10s %8s %12s %12s %12s %14s %14s"), TEXT("profile"), TEXT("samples"), TEXT("err avg cm"), TEXT("err p95 cm"), TEXT("corrections"), TEXT("input avg ms"), TEXT("input p95 ms"))
+	for(const FMatrixRow& Row : Matrix)
+	{
+		UE_LOG
+			( LogNet
+			, Display
+			, TEXT("NetQuality: %-10s %8d %12.1f %12.1f %12d %14.1f %14.1f")
+			, *Row.Profile
+			, Row.PositionErrors.Num()
+			, Average(Row.PositionErrors)
+			, Percentile(Row.PositionErrors, .95f)
+			, Row.Corrections
+			, Average(Row.InputLatencies)
+			, Percentile(Row.InputLatencies, .95f)
+			)
+	}
+}
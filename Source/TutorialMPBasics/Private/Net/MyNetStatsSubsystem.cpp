@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/MyNetStatsSubsystem.h"
+
+#include "TutorialMPBasics.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "MyPawn/MyPawn.h"
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Replication time (ms)"), STAT_ReplicationTime, STATGROUP_TutorialMPBasics);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Max connection budget use (%)"), STAT_MaxBudgetUse, STATGROUP_TutorialMPBasics);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Deferred pawn updates"), STAT_DeferredPawnUpdates, STATGROUP_TutorialMPBasics);
+
+namespace
+{
+	template<typename T>
+	T Percentile(TArray<T> Samples, float P)
+	{
+		if(Samples.IsEmpty())
+		{
+			return T();
+		}
+		Samples.Sort();
+		return Samples[FMath::Clamp(FMath::FloorToInt(P * Samples.Num()), 0, Samples.Num() - 1)];
+	}
+
+	template<typename T>
+	double Average(const TArray<T>& Samples)
+	{
+		double Sum = 0.;
+		for(const T Sample : Samples)
+		{
+			Sum += Sample;
+		}
+		return Samples.IsEmpty() ? 0. : Sum / Samples.Num();
+	}
+
+	const TCHAR* ReplicationBackendName()
+	{
+		const IConsoleVariable* CVarUseIris = IConsoleManager::Get().FindConsoleVariable(TEXT("net.Iris.UseIrisReplication"));
+		return CVarUseIris && CVarUseIris->GetInt() != 0 ? TEXT("Iris") : TEXT("Classic");
+	}
+
+	FAutoConsoleCommandWithWorld NetStatsCommand
+		( TEXT("mp.NetStats")
+		, TEXT("Log replication CPU time and bandwidth of this world")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyNetStatsSubsystem* NetStats = World->GetSubsystem<UMyNetStatsSubsystem>())
+			{
+				NetStats->LogReport();
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorld NetStatsResetCommand
+		( TEXT("mp.NetStats.Reset")
+		, TEXT("Discard all replication samples collected so far")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyNetStatsSubsystem* NetStats = World->GetSubsystem<UMyNetStatsSubsystem>())
+			{
+				NetStats->Reset();
+			}
+		})
+		);
+}
+
+void UMyNetStatsSubsystem::LogReport() const
+{
+	UE_LOG
+		( LogNet
+		, Display
+		, TEXT("NetBench: backend=%s clients=%d frames=%d replication ms avg=%.3f p50=%.3f p95=%.3f p99=%.3f out KB/s avg=%.1f p95=%.1f in KB/s avg=%.1f")
+		, ReplicationBackendName()
+		, MaxClientConnections
+		, ReplicationTimes.Num()
+		, Average(ReplicationTimes)
+		, Percentile(ReplicationTimes, .5f)
+		, Percentile(ReplicationTimes, .95f)
+		, Percentile(ReplicationTimes, .99f)
+		, Average(OutBytesPerSecond) / 1024.
+		, Percentile(OutBytesPerSecond, .95f) / 1024.
+		, Average(InBytesPerSecond) / 1024.
+		)
+
+	for(const TPair<TWeakObjectPtr<UNetConnection>, FConnectionStats>& Connection : ConnectionStats)
+	{
+		const FConnectionStats& Stats = Connection.Value;
+		UE_LOG
+			( LogNet
+			, Display
+			, TEXT("NetBench: connection=%s budget use avg=%.0f%% deferred pawn updates avg=%.1f max=%d")
+			, *Stats.Address
+			, Stats.Samples > 0 ? Stats.BudgetUse / Stats.Samples * 100. : 0.
+			, Stats.Samples > 0 ? static_cast<double>(Stats.DeferredUpdates) / Stats.Samples : 0.
+			, Stats.MaxDeferredUpdates
+			)
+	}
+}
+
+void UMyNetStatsSubsystem::Reset()
+{
+	ReplicationTimes.Reset();
+	OutBytesPerSecond.Reset();
+	InBytesPerSecond.Reset();
+	MaxClientConnections = 0;
+	ConnectionStats.Reset();
+}
+
+bool UMyNetStatsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && Cast<UWorld>(Outer)->IsGameWorld();
+}
+
+void UMyNetStatsSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	TickFlushHandle = InWorld.OnTickFlush().AddUObject(this, &UMyNetStatsSubsystem::HandleTickFlush);
+	PostTickFlushHandle = InWorld.OnPostTickFlush().AddUObject(this, &UMyNetStatsSubsystem::HandlePostTickFlush);
+
+	float BenchmarkDuration;
+	if(InWorld.GetNetMode() == NM_ListenServer && FParse::Value(FCommandLine::Get(), TEXT("NetBench="), BenchmarkDuration))
+	{
+		InWorld.GetTimerManager().SetTimer(BenchmarkTimer, this, &UMyNetStatsSubsystem::HandleBenchmarkEnd, BenchmarkDuration);
+	}
+}
+
+void UMyNetStatsSubsystem::Deinitialize()
+{
+	GetWorld()->OnTickFlush().Remove(TickFlushHandle);
+	GetWorld()->OnPostTickFlush().Remove(PostTickFlushHandle);
+	Super::Deinitialize();
+}
+
+void UMyNetStatsSubsystem::HandleTickFlush(float DeltaSeconds)
+{
+	TickFlushStartTime = FPlatformTime::Seconds();
+}
+
+void UMyNetStatsSubsystem::HandlePostTickFlush(float DeltaSeconds)
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if(!NetDriver || !NetDriver->IsServer() || NetDriver->ClientConnections.IsEmpty())
+	{
+		return;
+	}
+	const double Now = FPlatformTime::Seconds();
+	const float ReplicationTime = (Now - TickFlushStartTime) * 1000.;
+	ReplicationTimes.Add(ReplicationTime);
+	SET_FLOAT_STAT(STAT_ReplicationTime, ReplicationTime);
+
+	MaxClientConnections = FMath::Max(MaxClientConnections, NetDriver->ClientConnections.Num());
+
+	// the net driver updates its bandwidth numbers once per second
+	if(Now - LastBandwidthSampleTime >= 1.)
+	{
+		LastBandwidthSampleTime = Now;
+		OutBytesPerSecond.Add(NetDriver->OutBytesPerSecond);
+		InBytesPerSecond.Add(NetDriver->InBytesPerSecond);
+		SampleConnections(*NetDriver);
+	}
+}
+
+void UMyNetStatsSubsystem::SampleConnections(const UNetDriver& NetDriver)
+{
+	const double ElapsedTime = NetDriver.GetElapsedTime();
+	float MaxBudgetUse = 0.f;
+	int32 TotalDeferred = 0;
+	for(UNetConnection* Connection : NetDriver.ClientConnections)
+	{
+		if(!IsValid(Connection) || Connection->GetConnectionState() != USOCK_Open)
+		{
+			continue;
+		}
+		// the channel of an actor remembers when it last replicated for this very connection
+		int32 Deferred = 0;
+		for(auto It = Connection->ActorChannelConstIterator(); It; ++It)
+		{
+			const AMyPawn* Pawn = Cast<AMyPawn>(It.Key());
+			const UActorChannel* Channel = It.Value();
+			if(IsValid(Pawn) && Channel && Pawn->NetUpdateFrequency > 0.f
+				&& ElapsedTime - Channel->LastUpdateTime > 2. / Pawn->NetUpdateFrequency)
+			{
+				++Deferred;
+			}
+		}
+		const float BudgetUse = Connection->CurrentNetSpeed > 0
+			? static_cast<float>(Connection->OutBytesPerSecond) / Connection->CurrentNetSpeed
+			: 0.f;
+
+		FConnectionStats& Stats = ConnectionStats.FindOrAdd(Connection);
+		if(Stats.Address.IsEmpty())
+		{
+			Stats.Address = Connection->LowLevelGetRemoteAddress(true);
+		}
+		Stats.BudgetUse += BudgetUse;
+		Stats.DeferredUpdates += Deferred;
+		Stats.MaxDeferredUpdates = FMath::Max(Stats.MaxDeferredUpdates, Deferred);
+		++Stats.Samples;
+
+		MaxBudgetUse = FMath::Max(MaxBudgetUse, BudgetUse);
+		TotalDeferred += Deferred;
+	}
+	SET_FLOAT_STAT(STAT_MaxBudgetUse, MaxBudgetUse * 100.f);
+	SET_DWORD_STAT(STAT_DeferredPawnUpdates, TotalDeferred);
+}
+
+void UMyNetStatsSubsystem::HandleBenchmarkEnd()
+{
+	LogReport();
+	FPlatformMisc::RequestExit(false);
+}
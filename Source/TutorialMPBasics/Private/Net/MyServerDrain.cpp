@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/MyServerDrain.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "Modes/MyGISubsystem.h"
+#include "Modes/MyPlayerController.h"
+
+namespace
+{
+	FAutoConsoleCommandWithWorldAndArgs DrainCommand
+		( TEXT("mp.Drain")
+		, TEXT("mp.Drain [seconds]: stop accepting players, tell all clients to leave and end the session after the deadline; logs the progress when draining already")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			UMyServerDrain* Drain = World->GetSubsystem<UMyServerDrain>();
+			if(!Drain)
+			{
+				return;
+			}
+			if(Drain->IsDraining())
+			{
+				Drain->LogState();
+				return;
+			}
+			Drain->StartDrain(Args.IsEmpty() ? 0.f : FCString::Atof(*Args[0]));
+		})
+		);
+}
+
+void UMyServerDrain::StartDrain(float Seconds)
+{
+	UWorld* World = GetWorld();
+	if(bDraining || World->GetNetMode() == NM_Client || World->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+	bDraining = true;
+	StartTime = FPlatformTime::Seconds();
+	Deadline = StartTime + (Seconds > 0.f ? Seconds : DrainSeconds);
+
+	// nobody should find us anymore; those who found us already get rejected in `PreLogin`
+	World->GetGameInstance()->GetSubsystem<UMyGISubsystem>()->UpdateSession([] (FOnlineSessionSettings& Settings)
+	{
+		Settings.bShouldAdvertise = false;
+		Settings.bAllowJoinInProgress = false;
+		Settings.Set(SETTING_DRAINING, true, EOnlineDataAdvertisementType::ViaOnlineService);
+	});
+
+	UE_LOG(LogNet, Display, TEXT("%s: draining %d clients, deadline in %.0f s"), *GetFullName(), GetNumClients(), Deadline - StartTime)
+}
+
+int32 UMyServerDrain::GetNumClients() const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	return NetDriver ? NetDriver->ClientConnections.Num() : 0;
+}
+
+void UMyServerDrain::LogState() const
+{
+	UE_LOG
+		( LogNet
+		, Display
+		, TEXT("%s: draining %s, %d clients left, %d notified, %d closed, %.1f s to the deadline")
+		, *GetFullName()
+		, bTornDown ? TEXT("done") : bDraining ? TEXT("in progress") : TEXT("off")
+		, GetNumClients()
+		, Notified.Num()
+		, NumClosed
+		, bDraining ? FMath::Max(Deadline - FPlatformTime::Seconds(), 0.) : 0.
+		)
+}
+
+bool UMyServerDrain::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && Cast<UWorld>(Outer)->IsGameWorld();
+}
+
+void UMyServerDrain::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMyServerDrain::HandleWorldPostActorTick);
+}
+
+void UMyServerDrain::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	Super::Deinitialize();
+}
+
+void UMyServerDrain::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if(World != GetWorld() || !bDraining || bTornDown)
+	{
+		return;
+	}
+	SendNotices();
+	if(GetNumClients() == 0)
+	{
+		TearDown();
+	}
+	else if(FPlatformTime::Seconds() >= Deadline)
+	{
+		CloseConnections();
+	}
+}
+
+void UMyServerDrain::SendNotices()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if(!NetDriver)
+	{
+		return;
+	}
+	const float SecondsLeft = FMath::Max(Deadline - FPlatformTime::Seconds(), 0.);
+	int32 Sent = 0;
+	// also catches connections that were still logging in when the drain started
+	for(UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if(Sent >= NoticesPerFrame)
+		{
+			break;
+		}
+		AMyPlayerController* PC = Cast<AMyPlayerController>(Connection->PlayerController);
+		if(!IsValid(PC) || Notified.Contains(Connection))
+		{
+			continue;
+		}
+		PC->ClientRPC_ServerDraining(SecondsLeft);
+		Notified.Add(Connection);
+		++Sent;
+	}
+}
+
+void UMyServerDrain::CloseConnections()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	// a closed connection stays in `ClientConnections` until the net driver cleans it up, which may take a frame
+	const TArray<UNetConnection*> Connections = NetDriver->ClientConnections;
+	int32 Closed = 0;
+	for(UNetConnection* Connection : Connections)
+	{
+		if(Closed >= ClosesPerFrame)
+		{
+			break;
+		}
+		if(Connection->GetConnectionState() == USOCK_Closed)
+		{
+			continue;
+		}
+		Connection->Close();
+		++Closed;
+	}
+	NumClosed += Closed;
+}
+
+void UMyServerDrain::TearDown()
+{
+	bTornDown = true;
+	LogState();
+
+	UMyGISubsystem* GISub = GetWorld()->GetGameInstance()->GetSubsystem<UMyGISubsystem>();
+	const bool bExit = GetWorld()->GetNetMode() == NM_DedicatedServer && bExitWhenDrained;
+	if(!GISub->HasSession())
+	{
+		if(bExit)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+		else
+		{
+			GetWorld()->GetGameInstance()->ReturnToMainMenu();
+		}
+		return;
+	}
+	if(bExit)
+	{
+		// this world (and we) will be gone when the session is
+		GISub->OnSessionStage.AddLambda([] (ESessionStage Stage)
+		{
+			if(Stage == ESessionStage::Left)
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+		});
+	}
+	GISub->LeaveSession();
+}
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/MyServerGovernor.h"
+
+#include "TutorialMPBasics.h"
+#include "EngineUtils.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "MyPawn/MyPawn.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Governor net tick rate"), STAT_GovernorTickRate, STATGROUP_TutorialMPBasics);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Governor net update frequency"), STAT_GovernorNetUpdateFrequency, STATGROUP_TutorialMPBasics);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Governor load"), STAT_GovernorLoad, STATGROUP_TutorialMPBasics);
+
+namespace
+{
+	FAutoConsoleCommandWithWorld GovernorCommand
+		( TEXT("mp.Governor")
+		, TEXT("Log load and rates chosen by the server governor")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMyServerGovernor* Governor = World->GetSubsystem<UMyServerGovernor>())
+			{
+				Governor->LogState();
+			}
+		})
+		);
+}
+
+void UMyServerGovernor::LogState() const
+{
+	UE_LOG
+		( LogNet
+		, Display
+		, TEXT("%s: %d connections, frame time %.2f ms, load %.2f, net tick rate %d, net update frequency %.1f")
+		, *GetFullName()
+		, NumConnections
+		, AverageFrameTime * 1000.f
+		, Load
+		, GetTickRate()
+		, FMath::Lerp(MinNetUpdateFrequency, MaxNetUpdateFrequency, Level)
+		)
+}
+
+void UMyServerGovernor::ClampConnection(UNetConnection* Connection) const
+{
+	if(Connection)
+	{
+		// a client may ask for less (cf. `netspeed`, `UMyNetQualitySubsystem`), but not for more
+		Connection->CurrentNetSpeed = ClampNetSpeed(Connection->CurrentNetSpeed);
+	}
+}
+
+bool UMyServerGovernor::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && Cast<UWorld>(Outer)->IsGameWorld();
+}
+
+void UMyServerGovernor::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// clients have nothing to govern
+	if(InWorld.GetNetMode() != NM_ListenServer && InWorld.GetNetMode() != NM_DedicatedServer)
+	{
+		return;
+	}
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UMyServerGovernor::HandleWorldTickStart);
+	InWorld.GetTimerManager().SetTimer(EvaluationTimer, this, &UMyServerGovernor::Evaluate, EvaluationInterval, true);
+	Apply();
+}
+
+void UMyServerGovernor::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	Super::Deinitialize();
+}
+
+void UMyServerGovernor::HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if(World != GetWorld())
+	{
+		return;
+	}
+	// before anything gets replicated this frame: catches `netspeed` requests of the clients since the last frame
+	if(ConnectionBytesPerSecond > 0)
+	{
+		if(const UNetDriver* NetDriver = World->GetNetDriver())
+		{
+			for(UNetConnection* Connection : NetDriver->ClientConnections)
+			{
+				ClampConnection(Connection);
+			}
+		}
+	}
+
+	// the time the engine slept to honor the frame rate limit isn't load
+	AccumulatedFrameTime += static_cast<float>(FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.));
+	AccumulatedFrames++;
+}
+
+void UMyServerGovernor::Evaluate()
+{
+	if(AccumulatedFrames == 0)
+	{
+		return;
+	}
+	AverageFrameTime = AccumulatedFrameTime / AccumulatedFrames;
+	AccumulatedFrameTime = 0.f;
+	AccumulatedFrames = 0;
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+
+	// Against a fixed budget: measured against the budget of the current tick rate, lowering the tick rate would look
+	// like relief even where the frame time doesn't depend on it (listen server), and the governor would settle on
+	// the minimum rates.
+	Load = AverageFrameTime * MaxTickRate;
+	const bool bCanShedLoad = GetWorld()->GetNetMode() == NM_DedicatedServer;
+
+	// the level the player count asks for ...
+	const float Wanted = FMath::Clamp(static_cast<float>(NumConnections) / FMath::Max(FullConnectionCount, 1), 0.f, 1.f);
+	// ... is approached step by step, but only as long as the load permits
+	if(bCanShedLoad && Load > HighLoad)
+	{
+		Level = FMath::Max(Level - Step, 0.f);
+	}
+	else if(Wanted > Level && (!bCanShedLoad || Load < LowLoad))
+	{
+		Level = FMath::Min(Level + Step, Wanted);
+	}
+	else if(Wanted < Level)
+	{
+		Level = FMath::Max(Level - Step, Wanted);
+	}
+	Apply();
+}
+
+int32 UMyServerGovernor::GetTickRate() const
+{
+	if(GetWorld()->GetNetMode() != NM_DedicatedServer)
+	{
+		return 0;
+	}
+	return FMath::RoundToInt(FMath::Lerp<float>(MinTickRate, MaxTickRate, Level));
+}
+
+void UMyServerGovernor::Apply() const
+{
+	const int32 TickRate = GetTickRate();
+	const float NetUpdateFrequency = FMath::Lerp(MinNetUpdateFrequency, MaxNetUpdateFrequency, Level);
+
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if(NetDriver && TickRate > 0)
+	{
+		NetDriver->NetServerMaxTickRate = TickRate;
+	}
+	for(TActorIterator<AMyPawn> It(GetWorld()); It; ++It)
+	{
+		It->NetUpdateFrequency = NetUpdateFrequency;
+		// the minimum must not exceed the frequency, and it goes back up to the pawn's default with the frequency
+		It->MinNetUpdateFrequency = FMath::Min(It->GetClass()->GetDefaultObject<AMyPawn>()->MinNetUpdateFrequency, NetUpdateFrequency);
+	}
+
+	SET_DWORD_STAT(STAT_GovernorTickRate, TickRate);
+	SET_FLOAT_STAT(STAT_GovernorNetUpdateFrequency, NetUpdateFrequency);
+	SET_FLOAT_STAT(STAT_GovernorLoad, Load);
+}
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/MySessionAdvertiser.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "Modes/MyGISubsystem.h"
+#include "Net/MyServerDrain.h"
+#include "Net/MyServerGovernor.h"
+#include "TimerManager.h"
+
+namespace
+{
+	FAutoConsoleCommandWithWorld SessionAdvertCommand
+		( TEXT("mp.SessionAdvert")
+		, TEXT("Log the live session advertisement (players, load, level) and how many updates got coalesced")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(const UMySessionAdvertiser* Advertiser = World->GetSubsystem<UMySessionAdvertiser>())
+			{
+				Advertiser->LogState();
+			}
+		})
+		);
+}
+
+void UMySessionAdvertiser::MarkDirty()
+{
+	bDirty = true;
+	++Requests;
+}
+
+void UMySessionAdvertiser::LogState() const
+{
+	UE_LOG
+		( LogNet
+		, Display
+		, TEXT("%s: advertising %d players, load %.2f, level %s; %d requests, %d updates%s")
+		, *GetFullName()
+		, PublishedPlayers
+		, PublishedLoad
+		, *PublishedMap
+		, Requests
+		, Updates
+		, bDirty ? TEXT(", update pending") : TEXT("")
+		)
+}
+
+bool UMySessionAdvertiser::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && Cast<UWorld>(Outer)->IsGameWorld();
+}
+
+void UMySessionAdvertiser::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// only the host advertises
+	if(InWorld.GetNetMode() != NM_ListenServer && InWorld.GetNetMode() != NM_DedicatedServer)
+	{
+		return;
+	}
+	// new level
+	MarkDirty();
+	InWorld.GetTimerManager().SetTimer(CheckTimer, this, &UMySessionAdvertiser::Check, CheckInterval, true);
+}
+
+void UMySessionAdvertiser::Check()
+{
+	UWorld* World = GetWorld();
+	const UMyServerDrain* Drain = World->GetSubsystem<UMyServerDrain>();
+	if(Drain && Drain->IsDraining())
+	{
+		// not advertised anymore
+		return;
+	}
+	const UMyServerGovernor* Governor = World->GetSubsystem<UMyServerGovernor>();
+	const float Load = Governor ? Governor->GetLoad() : 0.f;
+	if(FMath::Abs(Load - PublishedLoad) >= LoadChangeThreshold)
+	{
+		MarkDirty();
+	}
+	const double Now = FPlatformTime::Seconds();
+	if(!bDirty || (LastUpdateTime >= 0. && Now - LastUpdateTime < MinUpdateInterval))
+	{
+		return;
+	}
+
+	const AGameModeBase* GameMode = World->GetAuthGameMode();
+	const int32 Players = GameMode ? GameMode->GetNumPlayers() : 0;
+	const FString Map = UWorld::RemovePIEPrefix(World->GetMapName());
+	const bool bUpdated = World->GetGameInstance()->GetSubsystem<UMyGISubsystem>()->UpdateSession([Players, Load, &Map] (FOnlineSessionSettings& Settings)
+	{
+		Settings.Set(SETTING_NUMPLAYERS, Players, EOnlineDataAdvertisementType::ViaOnlineService);
+		Settings.Set(SETTING_LOAD, Load, EOnlineDataAdvertisementType::ViaOnlineService);
+		Settings.Set(SETTING_MAPNAME, Map, EOnlineDataAdvertisementType::ViaOnlineService);
+	});
+	// without a session (yet), we stay dirty
+	if(!bUpdated)
+	{
+		return;
+	}
+	bDirty = false;
+	LastUpdateTime = Now;
+	PublishedPlayers = Players;
+	PublishedLoad = Load;
+	PublishedMap = Map;
+	++Updates;
+}
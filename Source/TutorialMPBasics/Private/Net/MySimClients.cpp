@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/MySimClients.h"
+
+#include "TutorialMPBasics.h"
+#include "Diagnostics/MyMemoryTags.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "Modes/MyPlayerController.h"
+#include "Net/MySimConnection.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Simulated clients"), STAT_SimClients, STATGROUP_TutorialMPBasics);
+
+namespace
+{
+#if WITH_SIM_CLIENTS
+	FAutoConsoleCommandWithWorld SimClientsCommand
+		( TEXT("mp.SimClients")
+		, TEXT("Log the simulated clients, the bytes sent to them and the frame times since the last call")
+		, FConsoleCommandWithWorldDelegate::CreateLambda([] (UWorld* World)
+		{
+			if(UMySimClients* SimClients = World->GetSubsystem<UMySimClients>())
+			{
+				SimClients->LogStats();
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorldAndArgs SimClientsAddCommand
+		( TEXT("mp.SimClients.Add")
+		, TEXT("mp.SimClients.Add [count]: add simulated clients to the hosted game")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			if(UMySimClients* SimClients = World->GetSubsystem<UMySimClients>())
+			{
+				SimClients->AddClients(Args.IsEmpty() ? 1 : FCString::Atoi(*Args[0]));
+			}
+		})
+		);
+
+	FAutoConsoleCommandWithWorldAndArgs SimClientsRemoveCommand
+		( TEXT("mp.SimClients.Remove")
+		, TEXT("mp.SimClients.Remove [count]: disconnect simulated clients, all of them without a count")
+		, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([] (const TArray<FString>& Args, UWorld* World)
+		{
+			if(UMySimClients* SimClients = World->GetSubsystem<UMySimClients>())
+			{
+				SimClients->RemoveClients(Args.IsEmpty() ? -1 : FCString::Atoi(*Args[0]));
+			}
+		})
+		);
+#endif
+}
+
+void UMySimClients::AddClients(int32 Count)
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if(!NetDriver || !NetDriver->IsServer())
+	{
+		UE_LOG(LogNet, Warning, TEXT("%s: simulated clients need a hosted game"), *GetFullName())
+		return;
+	}
+	PendingSpawns += FMath::Max(Count, 0);
+}
+
+void UMySimClients::RemoveClients(int32 Count)
+{
+	PendingSpawns = 0;
+	const int32 NumRemove = Count < 0 ? Clients.Num() : FMath::Min(Count, Clients.Num());
+	for(int32 i = 0; i < NumRemove; ++i)
+	{
+		// closing cleans up the connection, the player controller logs out like the one of a real client
+		if(UMySimConnection* Connection = Clients.Last().Connection.Get())
+		{
+			Connection->Close();
+		}
+		Clients.Pop(false);
+	}
+	SET_DWORD_STAT(STAT_SimClients, Clients.Num());
+	UE_LOG(LogNet, Display, TEXT("%s: removed %d simulated clients, %d left"), *GetFullName(), NumRemove, Clients.Num())
+}
+
+void UMySimClients::LogStats()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Seconds = FMath::Max(Now - StatsStartTime, 0.001);
+	int64 Bytes = 0;
+	int64 Packets = 0;
+	for(FSimClient& Client : Clients)
+	{
+		if(const UMySimConnection* Connection = Client.Connection.Get())
+		{
+			Bytes += Connection->GetBytesReceived() - Client.LoggedBytes;
+			Packets += Connection->GetPacketsReceived();
+			Client.LoggedBytes = Connection->GetBytesReceived();
+		}
+	}
+	UE_LOG
+		( LogNet
+		, Display
+		, TEXT("%s: %d simulated clients (%d pending) over %.1f s: %.1f KB/s sent to them, %.0f B/s per client, %lld packets total; %lld inputs; frames avg %.2f ms, max %.2f ms")
+		, *GetFullName()
+		, Clients.Num()
+		, PendingSpawns
+		, Seconds
+		, Bytes / 1024. / Seconds
+		, Clients.IsEmpty() ? 0. : Bytes / Seconds / Clients.Num()
+		, Packets
+		, StatsInputs
+		, StatsFrames > 0 ? Seconds * 1000. / StatsFrames : 0.
+		, StatsMaxFrame * 1000.f
+		)
+	StatsStartTime = Now;
+	StatsFrames = 0;
+	StatsMaxFrame = 0.f;
+	StatsInputs = 0;
+}
+
+bool UMySimClients::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if WITH_SIM_CLIENTS
+	return Super::ShouldCreateSubsystem(Outer) && Cast<UWorld>(Outer)->IsGameWorld();
+#else
+	return false;
+#endif
+}
+
+void UMySimClients::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMySimClients::HandleWorldPostActorTick);
+	StatsStartTime = FPlatformTime::Seconds();
+
+	int32 Count = 0;
+	if(InWorld.GetNetMode() == NM_DedicatedServer && FParse::Value(FCommandLine::Get(), TEXT("SimClients="), Count))
+	{
+		AddClients(Count);
+	}
+}
+
+void UMySimClients::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	SET_DWORD_STAT(STAT_SimClients, 0);
+	Super::Deinitialize();
+}
+
+void UMySimClients::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if(World != GetWorld())
+	{
+		return;
+	}
+	if(Clients.IsEmpty() && PendingSpawns == 0)
+	{
+		return;
+	}
+	++StatsFrames;
+	StatsMaxFrame = FMath::Max(StatsMaxFrame, DeltaSeconds);
+
+	// spread the logins over several frames, a real crowd doesn't arrive in the same frame either
+	for(int32 i = 0; i < SpawnsPerFrame && PendingSpawns > 0; ++i)
+	{
+		--PendingSpawns;
+		if(!SpawnClient())
+		{
+			PendingSpawns = 0;
+		}
+	}
+
+	// connections can also be closed by the host, e.g. when draining, cf. `UMyServerDrain`
+	Clients.RemoveAllSwap([] (const FSimClient& Client)
+	{
+		const UMySimConnection* Connection = Client.Connection.Get();
+		return !Connection || Connection->GetConnectionState() == USOCK_Closed;
+	});
+	SET_DWORD_STAT(STAT_SimClients, Clients.Num());
+
+	for(FSimClient& Client : Clients)
+	{
+		Client.NextInput -= DeltaSeconds;
+		if(Client.NextInput > 0.f)
+		{
+			continue;
+		}
+		Client.NextInput += InputInterval * FMath::FRandRange(0.5f, 1.5f);
+		// on the host, this is what `ServerRPC_HandleAction` does
+		if(AMyPlayerController* PC = Cast<AMyPlayerController>(Client.Connection->PlayerController))
+		{
+			PC->PerformAction(FMath::RandBool() ? EAction::Left : EAction::Right);
+			++StatsInputs;
+		}
+	}
+}
+
+bool UMySimClients::SpawnClient()
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Diagnostics);
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World->GetNetDriver();
+	if(!NetDriver || !NetDriver->IsServer())
+	{
+		return false;
+	}
+
+	FURL URL;
+	URL.AddOption(*FString::Printf(TEXT("Name=Sim%d"), NextClientId++));
+	UMySimConnection* Connection = NewObject<UMySimConnection>(NetDriver);
+	Connection->InitConnection(NetDriver, USOCK_Open, URL);
+	NetDriver->AddClientConnection(Connection);
+	// what a real client reports once it has loaded the map, without it nothing in the level replicates to us
+	Connection->SetClientWorldPackageName(NetDriver->GetWorldPackage()->GetFName());
+	Connection->SetClientLoginState(EClientLoginState::Welcomed);
+
+	FString Error;
+	APlayerController* PC = World->SpawnPlayActor(Connection, ROLE_AutonomousProxy, URL, FUniqueNetIdRepl(), Error);
+	if(!PC)
+	{
+		UE_LOG(LogNet, Error, TEXT("%s: simulated client login failed: %s"), *GetFullName(), *Error)
+		Connection->Close();
+		return false;
+	}
+
+	FSimClient& Client = Clients.AddDefaulted_GetRef();
+	Client.Connection = Connection;
+	// not everybody presses a key in the same frame
+	Client.NextInput = FMath::FRandRange(0.f, InputInterval);
+	return true;
+}
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/MySimConnection.h"
+
+#include "Engine/NetDriver.h"
+
+void UMySimConnection::InitConnection(UNetDriver* InDriver, EConnectionState InState, const FURL& InURL, int32 InConnectionSpeed, int32 InMaxPacket)
+{
+	Super::InitConnection(InDriver, InState, InURL, InConnectionSpeed, InMaxPacket);
+	SetInternalAck(true);
+	InitSendBuffer();
+}
+
+void UMySimConnection::LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	BytesReceived += FMath::DivideAndRoundUp(CountBits, 8);
+	++PacketsReceived;
+}
+
+FString UMySimConnection::LowLevelGetRemoteAddress(bool bAppendPort)
+{
+	return FString::Printf(TEXT("sim:%s"), *GetName());
+}
+
+FString UMySimConnection::LowLevelDescribe()
+{
+	return FString::Printf(TEXT("simulated client %s, state %d"), *GetName(), static_cast<int32>(GetConnectionState()));
+}
+
+void UMySimConnection::Tick(float DeltaSeconds)
+{
+	// there is nobody to hear from, but we don't want to be timed out either
+	LastReceiveTime = Driver->GetElapsedTime();
+	LastReceiveRealtime = FPlatformTime::Seconds();
+	Super::Tick(DeltaSeconds);
+}
@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Online/OnlineIdentityMock.h"
+
+#include "OnlineSubsystemTypes.h"
+#include "Online/OnlineSubsystemMock.h"
+
+FOnlineIdentityMock::FOnlineIdentityMock(FOnlineSubsystemMock* InSubsystem)
+	: Subsystem(InSubsystem)
+{
+}
+
+bool FOnlineIdentityMock::Login(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials)
+{
+	Subsystem->RunDelayed([this, LocalUserNum] (bool bFail)
+	{
+		if(bFail)
+		{
+			TriggerOnLoginCompleteDelegates(LocalUserNum, false, *FUniqueNetIdString::EmptyId(), TEXT("injected failure"));
+			return;
+		}
+		const FUniqueNetIdRef UserId = FUniqueNetIdString::Create(FString::Printf(TEXT("mock-%d"), NextUserId++), MOCK_SUBSYSTEM);
+		LoggedInUsers.Add(LocalUserNum, UserId);
+		TriggerOnLoginStatusChangedDelegates(LocalUserNum, ELoginStatus::NotLoggedIn, ELoginStatus::LoggedIn, *UserId);
+		TriggerOnLoginCompleteDelegates(LocalUserNum, true, *UserId, FString());
+	});
+	return true;
+}
+
+bool FOnlineIdentityMock::Logout(int32 LocalUserNum)
+{
+	Subsystem->RunDelayed([this, LocalUserNum] (bool bFail)
+	{
+		FUniqueNetIdRef UserId = FUniqueNetIdString::EmptyId();
+		const bool bSuccess = !bFail && LoggedInUsers.RemoveAndCopyValue(LocalUserNum, UserId);
+		if(bSuccess)
+		{
+			TriggerOnLoginStatusChangedDelegates(LocalUserNum, ELoginStatus::LoggedIn, ELoginStatus::NotLoggedIn, *UserId);
+		}
+		TriggerOnLogoutCompleteDelegates(LocalUserNum, bSuccess);
+	});
+	return true;
+}
+
+bool FOnlineIdentityMock::AutoLogin(int32 LocalUserNum)
+{
+	return Login(LocalUserNum, FOnlineAccountCredentials());
+}
+
+TSharedPtr<FUserOnlineAccount> FOnlineIdentityMock::GetUserAccount(const FUniqueNetId& UserId) const
+{
+	return nullptr;
+}
+
+TArray<TSharedPtr<FUserOnlineAccount>> FOnlineIdentityMock::GetAllUserAccounts() const
+{
+	return TArray<TSharedPtr<FUserOnlineAccount>>();
+}
+
+FUniqueNetIdPtr FOnlineIdentityMock::GetUniquePlayerId(int32 LocalUserNum) const
+{
+	const FUniqueNetIdRef* UserId = LoggedInUsers.Find(LocalUserNum);
+	return UserId ? FUniqueNetIdPtr(*UserId) : nullptr;
+}
+
+FUniqueNetIdPtr FOnlineIdentityMock::CreateUniquePlayerId(uint8* Bytes, int32 Size)
+{
+	if(Bytes == nullptr || Size <= 0)
+	{
+		return nullptr;
+	}
+	return CreateUniquePlayerId(BytesToString(Bytes, Size));
+}
+
+FUniqueNetIdPtr FOnlineIdentityMock::CreateUniquePlayerId(const FString& Str)
+{
+	return FUniqueNetIdString::Create(Str, MOCK_SUBSYSTEM);
+}
+
+ELoginStatus::Type FOnlineIdentityMock::GetLoginStatus(int32 LocalUserNum) const
+{
+	return LoggedInUsers.Contains(LocalUserNum) ? ELoginStatus::LoggedIn : ELoginStatus::NotLoggedIn;
+}
+
+ELoginStatus::Type FOnlineIdentityMock::GetLoginStatus(const FUniqueNetId& UserId) const
+{
+	for(const TPair<int32, FUniqueNetIdRef>& User : LoggedInUsers)
+	{
+		if(*User.Value == UserId)
+		{
+			return ELoginStatus::LoggedIn;
+		}
+	}
+	return ELoginStatus::NotLoggedIn;
+}
+
+FString FOnlineIdentityMock::GetPlayerNickname(int32 LocalUserNum) const
+{
+	const FUniqueNetIdRef* UserId = LoggedInUsers.Find(LocalUserNum);
+	return UserId ? (*UserId)->ToString() : FString();
+}
+
+FString FOnlineIdentityMock::GetPlayerNickname(const FUniqueNetId& UserId) const
+{
+	return UserId.ToString();
+}
+
+FString FOnlineIdentityMock::GetAuthToken(int32 LocalUserNum) const
+{
+	return GetPlayerNickname(LocalUserNum);
+}
+
+void FOnlineIdentityMock::RevokeAuthToken(const FUniqueNetId& LocalUserId, const FOnRevokeAuthTokenCompleteDelegate& Delegate)
+{
+	const FUniqueNetIdRef UserId = LocalUserId.AsShared();
+	Subsystem->RunDelayed([UserId, Delegate] (bool bFail)
+	{
+		Delegate.ExecuteIfBound(*UserId, FOnlineError(!bFail));
+	});
+}
+
+void FOnlineIdentityMock::GetUserPrivilege(const FUniqueNetId& LocalUserId, EUserPrivileges::Type Privilege, const FOnGetUserPrivilegeCompleteDelegate& Delegate)
+{
+	Delegate.ExecuteIfBound(LocalUserId, Privilege, static_cast<uint32>(EPrivilegeResults::NoFailures));
+}
+
+FPlatformUserId FOnlineIdentityMock::GetPlatformUserIdFromUniqueNetId(const FUniqueNetId& UniqueNetId) const
+{
+	for(const TPair<int32, FUniqueNetIdRef>& User : LoggedInUsers)
+	{
+		if(*User.Value == UniqueNetId)
+		{
+			return GetPlatformUserIdFromLocalUserNum(User.Key);
+		}
+	}
+	return PLATFORMUSERID_NONE;
+}
+
+FString FOnlineIdentityMock::GetAuthType() const
+{
+	return TEXT("Mock");
+}
@@ -0,0 +1,447 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Online/OnlineSessionMock.h"
+
+#include "Diagnostics/MyMemoryTags.h"
+#include "Modes/MyGISubsystem.h"
+#include "OnlineSubsystemTypes.h"
+#include "Online/OnlineSubsystemMock.h"
+
+FOnlineSessionInfoMock::FOnlineSessionInfoMock(const FString& InSessionId, const FString& InAddress)
+	: SessionId(FUniqueNetIdString::Create(InSessionId, MOCK_SUBSYSTEM))
+	, Address(InAddress)
+{
+}
+
+FOnlineSessionMock::FOnlineSessionMock(FOnlineSubsystemMock* InSubsystem)
+	: Subsystem(InSubsystem)
+{
+	GenerateFakeSessions();
+}
+
+void FOnlineSessionMock::GenerateFakeSessions()
+{
+	for(int32 i = 0; i < Subsystem->GetFakeSessionCount(); ++i)
+	{
+		FOnlineSessionSearchResult Result;
+		Result.PingInMs = 20 + i % 80;
+		Result.Session.OwningUserName = FString::Printf(TEXT("fake-host-%d"), i);
+		Result.Session.OwningUserId = FUniqueNetIdString::Create(Result.Session.OwningUserName, MOCK_SUBSYSTEM);
+		Result.Session.SessionInfo = MakeShared<FOnlineSessionInfoMock>(FString::Printf(TEXT("fake-session-%d"), i), Subsystem->GetFakeSessionAddress());
+		Result.Session.SessionSettings.NumPublicConnections = 4;
+		Result.Session.NumOpenPublicConnections = 4 - i % 4;
+		Result.Session.SessionSettings.bShouldAdvertise = true;
+		Result.Session.SessionSettings.bUsesPresence = true;
+		Result.Session.SessionSettings.bAllowJoinInProgress = true;
+		// the same type `UMyGISubsystem::CreateSession` stores, the joining side reads an `int32`
+		Result.Session.SessionSettings.Set(SETTING_LEVEL, (int32)ECurrentLevel::SomeLevel, EOnlineDataAdvertisementType::ViaOnlineService);
+		Result.Session.SessionSettings.Set(SETTING_CUSTOMNAME, Result.Session.OwningUserName, EOnlineDataAdvertisementType::ViaOnlineService);
+		FakeSessions.Add(MoveTemp(Result));
+	}
+}
+
+FUniqueNetIdPtr FOnlineSessionMock::CreateSessionIdFromString(const FString& SessionIdStr)
+{
+	return FUniqueNetIdString::Create(SessionIdStr, MOCK_SUBSYSTEM);
+}
+
+FNamedOnlineSession* FOnlineSessionMock::GetNamedSession(FName SessionName)
+{
+	return Sessions.FindByPredicate([SessionName] (const FNamedOnlineSession& Session) { return Session.SessionName == SessionName; });
+}
+
+void FOnlineSessionMock::RemoveNamedSession(FName SessionName)
+{
+	Sessions.RemoveAll([SessionName] (const FNamedOnlineSession& Session) { return Session.SessionName == SessionName; });
+}
+
+bool FOnlineSessionMock::HasPresenceSession()
+{
+	return Sessions.ContainsByPredicate([] (const FNamedOnlineSession& Session) { return Session.SessionSettings.bUsesPresence; });
+}
+
+EOnlineSessionState::Type FOnlineSessionMock::GetSessionState(FName SessionName) const
+{
+	const FNamedOnlineSession* Session = Sessions.FindByPredicate([SessionName] (const FNamedOnlineSession& Session) { return Session.SessionName == SessionName; });
+	return Session ? Session->SessionState : EOnlineSessionState::NoSession;
+}
+
+FNamedOnlineSession* FOnlineSessionMock::AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings)
+{
+	return &Sessions.Emplace_GetRef(SessionName, SessionSettings);
+}
+
+FNamedOnlineSession* FOnlineSessionMock::AddNamedSession(FName SessionName, const FOnlineSession& Session)
+{
+	return &Sessions.Emplace_GetRef(SessionName, Session);
+}
+
+bool FOnlineSessionMock::CreateSession(int32 HostingPlayerNum, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	if(GetNamedSession(SessionName) != nullptr)
+	{
+		UE_LOG(LogOnline, Warning, TEXT("OnlineSessionMock: session %s already exists"), *SessionName.ToString())
+		TriggerOnCreateSessionCompleteDelegates(SessionName, false);
+		return false;
+	}
+	FNamedOnlineSession* Session = AddNamedSession(SessionName, NewSessionSettings);
+	Session->SessionState = EOnlineSessionState::Creating;
+	Session->HostingPlayerNum = HostingPlayerNum;
+	Session->bHosting = true;
+	Session->NumOpenPublicConnections = NewSessionSettings.NumPublicConnections;
+	Session->NumOpenPrivateConnections = NewSessionSettings.NumPrivateConnections;
+	Session->OwningUserId = Subsystem->GetIdentityInterface()->GetUniquePlayerId(HostingPlayerNum);
+	Session->OwningUserName = Subsystem->GetIdentityInterface()->GetPlayerNickname(HostingPlayerNum);
+	Session->SessionInfo = MakeShared<FOnlineSessionInfoMock>(FString::Printf(TEXT("session-%s"), *SessionName.ToString()), TEXT("127.0.0.1"));
+
+	Subsystem->RunDelayed([this, SessionName] (bool bFail)
+	{
+		FNamedOnlineSession* Session = GetNamedSession(SessionName);
+		const bool bSuccess = !bFail && Session != nullptr;
+		if(bSuccess)
+		{
+			Session->SessionState = EOnlineSessionState::Pending;
+		}
+		else
+		{
+			RemoveNamedSession(SessionName);
+		}
+		TriggerOnCreateSessionCompleteDelegates(SessionName, bSuccess);
+	});
+	return true;
+}
+
+bool FOnlineSessionMock::CreateSession(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	return CreateSession(0, SessionName, NewSessionSettings);
+}
+
+bool FOnlineSessionMock::StartSession(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if(Session != nullptr)
+	{
+		Session->SessionState = EOnlineSessionState::InProgress;
+	}
+	TriggerOnStartSessionCompleteDelegates(SessionName, Session != nullptr);
+	return Session != nullptr;
+}
+
+bool FOnlineSessionMock::UpdateSession(FName SessionName, FOnlineSessionSettings& UpdatedSessionSettings, bool bShouldRefreshOnlineData)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if(Session == nullptr)
+	{
+		TriggerOnUpdateSessionCompleteDelegates(SessionName, false);
+		return false;
+	}
+	Session->SessionSettings = UpdatedSessionSettings;
+	Subsystem->RunDelayed([this, SessionName] (bool bFail)
+	{
+		TriggerOnUpdateSessionCompleteDelegates(SessionName, !bFail);
+	});
+	return true;
+}
+
+bool FOnlineSessionMock::EndSession(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if(Session != nullptr)
+	{
+		Session->SessionState = EOnlineSessionState::Ended;
+	}
+	TriggerOnEndSessionCompleteDelegates(SessionName, Session != nullptr);
+	return Session != nullptr;
+}
+
+bool FOnlineSessionMock::DestroySession(FName SessionName, const FOnDestroySessionCompleteDelegate& CompletionDelegate)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if(Session == nullptr)
+	{
+		CompletionDelegate.ExecuteIfBound(SessionName, false);
+		TriggerOnDestroySessionCompleteDelegates(SessionName, false);
+		return false;
+	}
+	Session->SessionState = EOnlineSessionState::Destroying;
+	// destroying never fails: a failed destroy would leave the caller with a session it cannot get rid of
+	Subsystem->RunDelayed([this, SessionName, CompletionDelegate] (bool)
+	{
+		RemoveNamedSession(SessionName);
+		CompletionDelegate.ExecuteIfBound(SessionName, true);
+		TriggerOnDestroySessionCompleteDelegates(SessionName, true);
+	});
+	return true;
+}
+
+bool FOnlineSessionMock::IsPlayerInSession(FName SessionName, const FUniqueNetId& UniqueId)
+{
+	const FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	return Session && Session->RegisteredPlayers.ContainsByPredicate([&UniqueId] (const FUniqueNetIdRef& Player) { return *Player == UniqueId; });
+}
+
+bool FOnlineSessionMock::StartMatchmaking(const TArray<FUniqueNetIdRef>& LocalPlayers, FName SessionName, const FOnlineSessionSettings& NewSessionSettings, TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	TriggerOnMatchmakingCompleteDelegates(SessionName, false);
+	return false;
+}
+
+bool FOnlineSessionMock::CancelMatchmaking(int32 SearchingPlayerNum, FName SessionName)
+{
+	TriggerOnCancelMatchmakingCompleteDelegates(SessionName, false);
+	return false;
+}
+
+bool FOnlineSessionMock::CancelMatchmaking(const FUniqueNetId& SearchingPlayerId, FName SessionName)
+{
+	return CancelMatchmaking(0, SessionName);
+}
+
+bool FOnlineSessionMock::FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	if(CurrentSearch.IsValid())
+	{
+		UE_LOG(LogOnline, Warning, TEXT("OnlineSessionMock: a search is in progress already"))
+		TriggerOnFindSessionsCompleteDelegates(false);
+		return false;
+	}
+	CurrentSearch = SearchSettings;
+	SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+	SearchSettings->SearchResults.Reset();
+
+	Subsystem->RunDelayed([this, SearchSettings] (bool bFail)
+	{
+		// the results belong to the session search, not to the online subsystem
+		LLM_SCOPE_BYTAG(TutorialMPBasics_Sessions);
+		if(CurrentSearch != SearchSettings)
+		{
+			// canceled meanwhile
+			return;
+		}
+		CurrentSearch.Reset();
+		if(bFail)
+		{
+			SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
+			TriggerOnFindSessionsCompleteDelegates(false);
+			return;
+		}
+		// the sessions of this process first, then the fake ones
+		for(const FNamedOnlineSession& Session : Sessions)
+		{
+			if(Session.bHosting && Session.SessionSettings.bShouldAdvertise && SearchSettings->SearchResults.Num() < SearchSettings->MaxSearchResults)
+			{
+				FOnlineSessionSearchResult& Result = SearchSettings->SearchResults.AddDefaulted_GetRef();
+				Result.Session = Session;
+				Result.PingInMs = 0;
+			}
+		}
+		const int32 NumFake = FMath::Min(FakeSessions.Num(), SearchSettings->MaxSearchResults - SearchSettings->SearchResults.Num());
+		SearchSettings->SearchResults.Append(FakeSessions.GetData(), FMath::Max(NumFake, 0));
+		SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+		TriggerOnFindSessionsCompleteDelegates(true);
+	});
+	return true;
+}
+
+bool FOnlineSessionMock::FindSessions(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	return FindSessions(0, SearchSettings);
+}
+
+bool FOnlineSessionMock::FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId, const FUniqueNetId& FriendId, const FOnSingleSessionResultCompleteDelegate& CompletionDelegate)
+{
+	CompletionDelegate.ExecuteIfBound(0, false, FOnlineSessionSearchResult());
+	return false;
+}
+
+bool FOnlineSessionMock::CancelFindSessions()
+{
+	if(!CurrentSearch.IsValid())
+	{
+		TriggerOnCancelFindSessionsCompleteDelegates(false);
+		return false;
+	}
+	CurrentSearch->SearchState = EOnlineAsyncTaskState::Failed;
+	CurrentSearch.Reset();
+	TriggerOnCancelFindSessionsCompleteDelegates(true);
+	return true;
+}
+
+bool FOnlineSessionMock::PingSearchResults(const FOnlineSessionSearchResult& SearchResult)
+{
+	return false;
+}
+
+bool FOnlineSessionMock::JoinSession(int32 LocalUserNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	if(GetNamedSession(SessionName) != nullptr)
+	{
+		TriggerOnJoinSessionCompleteDelegates(SessionName, EOnJoinSessionCompleteResult::AlreadyInSession);
+		return false;
+	}
+	if(!DesiredSession.Session.SessionInfo.IsValid())
+	{
+		TriggerOnJoinSessionCompleteDelegates(SessionName, EOnJoinSessionCompleteResult::SessionDoesNotExist);
+		return false;
+	}
+	FNamedOnlineSession* Session = AddNamedSession(SessionName, DesiredSession.Session);
+	Session->SessionState = EOnlineSessionState::Pending;
+	Session->HostingPlayerNum = LocalUserNum;
+	Session->bHosting = false;
+
+	Subsystem->RunDelayed([this, SessionName] (bool bFail)
+	{
+		if(GetNamedSession(SessionName) == nullptr)
+		{
+			// destroyed meanwhile
+			TriggerOnJoinSessionCompleteDelegates(SessionName, EOnJoinSessionCompleteResult::UnknownError);
+			return;
+		}
+		if(bFail)
+		{
+			RemoveNamedSession(SessionName);
+			TriggerOnJoinSessionCompleteDelegates(SessionName, EOnJoinSessionCompleteResult::CouldNotRetrieveAddress);
+			return;
+		}
+		TriggerOnJoinSessionCompleteDelegates(SessionName, EOnJoinSessionCompleteResult::Success);
+	});
+	return true;
+}
+
+bool FOnlineSessionMock::JoinSession(const FUniqueNetId& LocalUserId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	return JoinSession(0, SessionName, DesiredSession);
+}
+
+bool FOnlineSessionMock::FindFriendSession(int32 LocalUserNum, const FUniqueNetId& Friend)
+{
+	TriggerOnFindFriendSessionCompleteDelegates(LocalUserNum, false, TArray<FOnlineSessionSearchResult>());
+	return false;
+}
+
+bool FOnlineSessionMock::FindFriendSession(const FUniqueNetId& LocalUserId, const FUniqueNetId& Friend)
+{
+	return FindFriendSession(0, Friend);
+}
+
+bool FOnlineSessionMock::FindFriendSession(const FUniqueNetId& LocalUserId, const TArray<FUniqueNetIdRef>& FriendList)
+{
+	TriggerOnFindFriendSessionCompleteDelegates(0, false, TArray<FOnlineSessionSearchResult>());
+	return false;
+}
+
+bool FOnlineSessionMock::SendSessionInviteToFriend(int32 LocalUserNum, FName SessionName, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FOnlineSessionMock::SendSessionInviteToFriend(const FUniqueNetId& LocalUserId, FName SessionName, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FOnlineSessionMock::SendSessionInviteToFriends(int32 LocalUserNum, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+	return false;
+}
+
+bool FOnlineSessionMock::SendSessionInviteToFriends(const FUniqueNetId& LocalUserId, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+	return false;
+}
+
+bool FOnlineSessionMock::GetResolvedConnectString(FName SessionName, FString& ConnectInfo, FName PortType)
+{
+	const FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if(Session == nullptr || !Session->SessionInfo.IsValid())
+	{
+		return false;
+	}
+	ConnectInfo = StaticCastSharedPtr<FOnlineSessionInfoMock>(Session->SessionInfo)->Address;
+	return true;
+}
+
+bool FOnlineSessionMock::GetResolvedConnectString(const FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo)
+{
+	if(!SearchResult.Session.SessionInfo.IsValid())
+	{
+		return false;
+	}
+	ConnectInfo = StaticCastSharedPtr<const FOnlineSessionInfoMock>(SearchResult.Session.SessionInfo)->Address;
+	return true;
+}
+
+FOnlineSessionSettings* FOnlineSessionMock::GetSessionSettings(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	return Session ? &Session->SessionSettings : nullptr;
+}
+
+bool FOnlineSessionMock::RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited)
+{
+	return RegisterPlayers(SessionName, {PlayerId.AsShared()}, bWasInvited);
+}
+
+bool FOnlineSessionMock::RegisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players, bool bWasInvited)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if(Session != nullptr)
+	{
+		for(const FUniqueNetIdRef& Player : Players)
+		{
+			if(!IsPlayerInSession(SessionName, *Player))
+			{
+				Session->RegisteredPlayers.Add(Player);
+				Session->NumOpenPublicConnections = FMath::Max(Session->NumOpenPublicConnections - 1, 0);
+			}
+		}
+	}
+	TriggerOnRegisterPlayersCompleteDelegates(SessionName, Players, Session != nullptr);
+	return Session != nullptr;
+}
+
+bool FOnlineSessionMock::UnregisterPlayer(FName SessionName, const FUniqueNetId& PlayerId)
+{
+	return UnregisterPlayers(SessionName, {PlayerId.AsShared()});
+}
+
+bool FOnlineSessionMock::UnregisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if(Session != nullptr)
+	{
+		for(const FUniqueNetIdRef& Player : Players)
+		{
+			if(Session->RegisteredPlayers.RemoveAll([&Player] (const FUniqueNetIdRef& Registered) { return *Registered == *Player; }) > 0)
+			{
+				Session->NumOpenPublicConnections = FMath::Min(Session->NumOpenPublicConnections + 1, Session->SessionSettings.NumPublicConnections);
+			}
+		}
+	}
+	TriggerOnUnregisterPlayersCompleteDelegates(SessionName, Players, Session != nullptr);
+	return Session != nullptr;
+}
+
+void FOnlineSessionMock::RegisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnRegisterLocalPlayerCompleteDelegate& Delegate)
+{
+	Delegate.ExecuteIfBound(PlayerId, EOnJoinSessionCompleteResult::Success);
+}
+
+void FOnlineSessionMock::UnregisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& Delegate)
+{
+	Delegate.ExecuteIfBound(PlayerId, true);
+}
+
+int32 FOnlineSessionMock::GetNumSessions()
+{
+	return Sessions.Num();
+}
+
+void FOnlineSessionMock::DumpSessionState()
+{
+	for(const FNamedOnlineSession& Session : Sessions)
+	{
+		DumpNamedSession(&Session);
+	}
+}
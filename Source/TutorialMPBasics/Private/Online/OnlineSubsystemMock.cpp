@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Online/OnlineSubsystemMock.h"
+
+#include "Diagnostics/MyMemoryTags.h"
+#include "Online/OnlineIdentityMock.h"
+#include "Online/OnlineSessionMock.h"
+
+#define LOCTEXT_NAMESPACE "OnlineSubsystemMock"
+
+namespace
+{
+	const TCHAR* ConfigSection = TEXT("OnlineSubsystemMock");
+}
+
+FOnlineSubsystemMock::FOnlineSubsystemMock(FName InInstanceName)
+	: FOnlineSubsystemImpl(MOCK_SUBSYSTEM, InInstanceName)
+{
+}
+
+IOnlineSessionPtr FOnlineSubsystemMock::GetSessionInterface() const
+{
+	return SessionInterface;
+}
+
+IOnlineIdentityPtr FOnlineSubsystemMock::GetIdentityInterface() const
+{
+	return IdentityInterface;
+}
+
+bool FOnlineSubsystemMock::Init()
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Online);
+	GConfig->GetFloat(ConfigSection, TEXT("LatencyMs"), LatencyMs, GEngineIni);
+	GConfig->GetFloat(ConfigSection, TEXT("JitterMs"), JitterMs, GEngineIni);
+	GConfig->GetFloat(ConfigSection, TEXT("FailureRate"), FailureRate, GEngineIni);
+	GConfig->GetInt(ConfigSection, TEXT("FakeSessionCount"), FakeSessionCount, GEngineIni);
+	GConfig->GetString(ConfigSection, TEXT("FakeSessionAddress"), FakeSessionAddress, GEngineIni);
+
+	IdentityInterface = MakeShared<FOnlineIdentityMock, ESPMode::ThreadSafe>(this);
+	SessionInterface = MakeShared<FOnlineSessionMock, ESPMode::ThreadSafe>(this);
+
+	UE_LOG
+		( LogOnline
+		, Display
+		, TEXT("OnlineSubsystemMock: latency %.0f +- %.0f ms, failure rate %.2f, %d fake sessions")
+		, LatencyMs
+		, JitterMs
+		, FailureRate
+		, FakeSessionCount
+		)
+	return true;
+}
+
+bool FOnlineSubsystemMock::Shutdown()
+{
+	FOnlineSubsystemImpl::Shutdown();
+	PendingTasks.Empty();
+	SessionInterface.Reset();
+	IdentityInterface.Reset();
+	return true;
+}
+
+FString FOnlineSubsystemMock::GetAppId() const
+{
+	return TEXT("Mock");
+}
+
+FText FOnlineSubsystemMock::GetOnlineServiceName() const
+{
+	return LOCTEXT("OnlineServiceName", "Mock");
+}
+
+bool FOnlineSubsystemMock::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(TutorialMPBasics_Online);
+	if(!FOnlineSubsystemImpl::Tick(DeltaTime))
+	{
+		return false;
+	}
+	const double Now = FPlatformTime::Seconds();
+	// a task may queue further tasks, thus take the due ones out first
+	TArray<FPendingTask> DueTasks;
+	for(int32 i = PendingTasks.Num() - 1; i >= 0; --i)
+	{
+		if(PendingTasks[i].DueTime <= Now)
+		{
+			DueTasks.Add(MoveTemp(PendingTasks[i]));
+			PendingTasks.RemoveAtSwap(i, 1, false);
+		}
+	}
+	DueTasks.Sort([] (const FPendingTask& A, const FPendingTask& B) { return A.DueTime < B.DueTime; });
+	for(FPendingTask& Task : DueTasks)
+	{
+		Task.Task(Task.bFail);
+	}
+	return true;
+}
+
+void FOnlineSubsystemMock::RunDelayed(TFunction<void(bool bFail)> Task)
+{
+	const float Delay = FMath::Max(LatencyMs + FMath::FRandRange(-JitterMs, JitterMs), 0.f) / 1000.f;
+	PendingTasks.Add({FPlatformTime::Seconds() + Delay, FMath::FRand() < FailureRate, MoveTemp(Task)});
+}
+
+IOnlineSubsystemPtr FOnlineFactoryMock::CreateSubsystem(FName InstanceName)
+{
+	TSharedRef<FOnlineSubsystemMock, ESPMode::ThreadSafe> Subsystem = MakeShared<FOnlineSubsystemMock, ESPMode::ThreadSafe>(InstanceName);
+	if(!Subsystem->Init())
+	{
+		Subsystem->Shutdown();
+		return nullptr;
+	}
+	return Subsystem;
+}
+
+#undef LOCTEXT_NAMESPACE
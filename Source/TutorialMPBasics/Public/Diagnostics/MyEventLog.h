@@ -0,0 +1,214 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/CriticalSection.h"
+#include "UObject/Object.h"
+
+#include <atomic>
+
+/*
+ * All events of the structured event log, with the text they decode to: `{n}` gets replaced by the n-th argument.
+ * Ids are the position in this list, thus only ever append to it; the decoder reads the table from the file header.
+ */
+#define MP_EVENT_LIST(X) \
+	X(SessionStage, "session stage {0} (ESessionStage)") \
+	X(SessionDelegateCleared, "{0}: was bound, clearing") \
+	X(SessionDestroyRetry, "failed to destroy session, trying again ...") \
+	X(SessionDestroyed, "session destroyed") \
+	X(LoginComplete, "login of player num {0}: success {1}") \
+	X(LogoutComplete, "player {0} log out: success {1}") \
+	X(PawnPoolNoMyPawn, "DefaultPawnClass isn't a MyPawn, no pooling") \
+	X(PawnPoolStats, "pawn pool: {0} hits, {1} misses, {2} pooled; garbage collection: {3} runs") \
+	X(GarbageCollectTime, "garbage collection: {0} ms total") \
+	X(NoPawnSpawned, "no pawn spawned for {0}") \
+	X(CreateSessionComplete, "create session {0}: success {1}") \
+	X(JoinSessionComplete, "join session: result {0} (EOnJoinSessionCompleteResult), level {1} (ECurrentLevel)") \
+	X(LocalPlayerSessionStage, "local player with controller id {0}: session stage {1} (ESessionStage)") \
+	X(HUDClassMissing, "{0} not set, no widget")
+
+enum class EMyEvent : uint16
+{
+#define MP_EVENT_ENUM(Name, Format) Name,
+	MP_EVENT_LIST(MP_EVENT_ENUM)
+#undef MP_EVENT_ENUM
+	Num
+};
+
+/**
+ * A binary event log for diagnostics that stay on in shipped builds.
+ *
+ * Instead of formatting a string with `GetFullName()` for every `UE_LOG`, `MP_EVENT(Event, Object, Args...)` writes
+ * a fixed-size record (event id, timestamp in cycles, object name and unique id, up to four typed arguments) into a
+ * ring buffer owned by the calling thread. No locks, no allocations, no string formatting: a handful of stores.
+ *
+ * A background thread drains all rings every `mp.EventLog.FlushInterval` seconds into
+ * "Saved/Logs/Events-<date>.mpev", resolving FNames there. "decode_events.py" in the project root turns such a file
+ * into text. With `mp.EventLog.Echo 1` the flush thread additionally prints every event to the regular log, for
+ * development.
+ *
+ * When a ring is full (the flush thread fell behind), further events of that thread get dropped and counted; the
+ * count shows up in the file.
+ *
+ * Errors stay regular `UE_LOG` calls: they are rare and have to show up in the log right away. The HUDs are the
+ * exception, a widget class missing in their Blueprint is an event like anything else they report.
+ *
+ * The module opens the file at startup; in the editor, only with the first game world (PIE).
+ */
+class TUTORIALMPBASICS_API FMyEventLog
+{
+public:
+	enum class EArgType : uint8
+	{
+		Int,
+		Float,
+		Bool,
+		Name,
+	};
+
+	static constexpr int32 MaxArgs = 4;
+
+	struct FRecord
+	{
+		uint64 Cycles;
+		uint64 Args[MaxArgs];
+		uint32 ObjectId;
+		uint32 ObjectName;
+		uint32 ObjectNameNumber;
+		EMyEvent Event;
+		uint8 NumArgs;
+		EArgType ArgTypes[MaxArgs];
+	};
+
+	static FMyEventLog& Get();
+
+	// called by the module
+	void Start();
+	void Stop();
+
+	bool IsEnabled() const
+	{
+		return bRunning.load(std::memory_order_relaxed) && bEnabled.load(std::memory_order_relaxed);
+	}
+
+	// Write everything recorded so far to disk, synchronously; game thread only.
+	void Flush();
+
+	template<typename... ArgTypes>
+	void Record(EMyEvent Event, const UObject* Object, ArgTypes... Args)
+	{
+		static_assert(sizeof...(Args) <= MaxArgs, "too many event arguments");
+		FRecord* Record = BeginRecord();
+		if(Record == nullptr)
+		{
+			return;
+		}
+		Record->Cycles = FPlatformTime::Cycles64();
+		Record->Event = Event;
+		if(Object)
+		{
+			const FName Name = Object->GetFName();
+			Record->ObjectId = Object->GetUniqueID();
+			Record->ObjectName = Name.GetDisplayIndex().ToUnstableInt();
+			Record->ObjectNameNumber = Name.GetNumber();
+		}
+		else
+		{
+			Record->ObjectId = 0;
+			Record->ObjectName = 0;
+			Record->ObjectNameNumber = 0;
+		}
+		Record->NumArgs = 0;
+		(SetArg(*Record, Args), ...);
+		EndRecord();
+	}
+
+	static const TCHAR* GetEventFormat(EMyEvent Event);
+
+private:
+	// single producer (the owning thread), single consumer (the flush thread)
+	struct FRing
+	{
+		static constexpr uint32 Capacity = 4096;
+
+		FRecord Records[Capacity];
+		std::atomic<uint32> Head{0};
+		std::atomic<uint32> Tail{0};
+		std::atomic<uint32> Dropped{0};
+		uint32 ThreadId = 0;
+	};
+
+	FRecord* BeginRecord();
+	void EndRecord();
+
+	template<typename T>
+	static void SetArg(FRecord& Record, T Value)
+	{
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			PushArg(Record, EArgType::Bool, Value ? 1 : 0);
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			const double Double = Value;
+			uint64 Bits;
+			FMemory::Memcpy(&Bits, &Double, sizeof(Bits));
+			PushArg(Record, EArgType::Float, Bits);
+		}
+		else if constexpr (std::is_same_v<T, FName>)
+		{
+			PushArg(Record, EArgType::Name, static_cast<uint64>(Value.GetNumber()) << 32 | Value.GetDisplayIndex().ToUnstableInt());
+		}
+		else
+		{
+			static_assert(std::is_integral_v<T> || std::is_enum_v<T>, "unsupported event argument type");
+			PushArg(Record, EArgType::Int, static_cast<uint64>(static_cast<int64>(Value)));
+		}
+	}
+
+	static void PushArg(FRecord& Record, EArgType Type, uint64 Value)
+	{
+		Record.ArgTypes[Record.NumArgs] = Type;
+		Record.Args[Record.NumArgs] = Value;
+		++Record.NumArgs;
+	}
+
+	FRing& GetThreadRing();
+
+	// flush thread
+	void FlushThreadMain();
+	void Drain();
+	void WriteRecord(const FRecord& Record, uint32 ThreadId);
+	void WriteName(uint32 DisplayIndex);
+	FString FormatRecord(const FRecord& Record) const;
+
+	std::atomic<bool> bRunning{false};
+	std::atomic<bool> bEnabled{true};
+
+	FCriticalSection RingsLock;
+	// never shrinks: threads keep a pointer to their ring for their whole lifetime
+	TArray<TUniquePtr<FRing>> Rings;
+
+	// flush thread only
+	FCriticalSection DrainLock;
+	TUniquePtr<IFileHandle> File;
+	TArray<uint8> Buffer;
+	TSet<uint32> WrittenNames;
+	uint64 StartCycles = 0;
+
+	class FRunnableThread* Thread = nullptr;
+	class FEvent* WakeUp = nullptr;
+	class FFlushRunnable* Runnable = nullptr;
+	friend class FFlushRunnable;
+};
+
+#define MP_EVENT(Event, Object, ...) \
+	do \
+	{ \
+		if(FMyEventLog::Get().IsEnabled()) \
+		{ \
+			FMyEventLog::Get().Record(EMyEvent::Event, Object, ##__VA_ARGS__); \
+		} \
+	} while(0)
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MyMemoryReport.generated.h"
+
+/*
+ * where the game instance is, as far as memory is concerned
+ */
+UENUM()
+enum class EMemoryPhase : uint8
+{
+	Menu      UMETA(DisplayName="menu"),
+	Searching UMETA(DisplayName="searching"),
+	InLevel   UMETA(DisplayName="in level"),
+	Num       UMETA(Hidden)
+};
+
+/*
+ * memory budget for one phase
+ */
+USTRUCT()
+struct FMemoryPhaseBudget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	EMemoryPhase Phase = EMemoryPhase::Menu;
+
+	// used physical memory of the process
+	UPROPERTY(Config)
+	float MB = 0.f;
+};
+
+/**
+ * Memory per session phase: every `SampleInterval` seconds, samples the used physical memory of the process and, with
+ * `-LLM`, the amount booked on each tag of "Diagnostics/MyMemoryTags.h", and books the samples on the current phase
+ * (menu, searching sessions, in a level; a dedicated server is always in a level).
+ *
+ * `mp.MemReport` logs current and peak amounts per phase. When the process exceeds the budget of the current phase
+ * (`Budgets`), a warning gets logged, once per visit of the phase.
+ *
+ * `-MemReportOnExit` logs the report on shutdown, for headless runs, e.g. a dedicated server under a load test:
+ * the peak "in level" is the number to size server instances with.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMyMemoryReport : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void LogReport() const;
+
+protected:
+	// event handlers
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UPROPERTY(Config)
+	float SampleInterval = 1.f;
+
+	UPROPERTY(Config)
+	TArray<FMemoryPhaseBudget> Budgets;
+
+private:
+	bool Tick(float DeltaTime);
+	EMemoryPhase GetPhase() const;
+	void Sample();
+
+	struct FAmount
+	{
+		int64 Current = 0;
+		int64 Peak = 0;
+
+		void Add(int64 Bytes)
+		{
+			Current = Bytes;
+			Peak = FMath::Max(Peak, Bytes);
+		}
+	};
+
+	struct FPhaseStats
+	{
+		int32 Samples = 0;
+		FAmount Process;
+		// same order as the tags in "MyMemoryReport.cpp"
+		TArray<FAmount> Tags;
+	};
+
+	FPhaseStats Phases[static_cast<int32>(EMemoryPhase::Num)];
+
+	EMemoryPhase LastPhase = EMemoryPhase::Num;
+	bool bBudgetWarned = false;
+	float SinceSample = 0.f;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/*
+ * Low level memory tracker tags of this module, one per group of systems. Put `LLM_SCOPE_BYTAG(TutorialMPBasics_<Tag>)`
+ * at the top of a function that allocates on behalf of that group: every allocation of the current thread within the
+ * scope gets booked on the tag, also the ones deep down in engine code (containers, UObjects, Slate).
+ *
+ * The tracker is compiled into non-shipping builds and has to be switched on with `-LLM` on the command line; then
+ * `stat LLMFULL` shows the tags under "TutorialMPBasics", and `mp.MemReport` lists them per session phase, cf.
+ * `UMyMemoryReport`.
+ *
+ * Underscores in the names become slashes: the tags are children of "TutorialMPBasics".
+ */
+LLM_DECLARE_TAG_API(TutorialMPBasics, TUTORIALMPBASICS_API);
+// session settings, search results (up to 10000) and the closures bound to the session interface
+LLM_DECLARE_TAG_API(TutorialMPBasics_Sessions, TUTORIALMPBASICS_API);
+// the mock online subsystem itself, cf. `FOnlineSubsystemMock`
+LLM_DECLARE_TAG_API(TutorialMPBasics_Online, TUTORIALMPBASICS_API);
+// pawns, the pawn pool, lag compensation history, instanced rendering
+LLM_DECLARE_TAG_API(TutorialMPBasics_Pawns, TUTORIALMPBASICS_API);
+// lockstep simulation, snapshots and frames
+LLM_DECLARE_TAG_API(TutorialMPBasics_Lockstep, TUTORIALMPBASICS_API);
+// HUD, main menu and loading screen widgets
+LLM_DECLARE_TAG_API(TutorialMPBasics_HUD, TUTORIALMPBASICS_API);
+// event log rings and buffers
+LLM_DECLARE_TAG_API(TutorialMPBasics_Diagnostics, TUTORIALMPBASICS_API);
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MyAssetPrewarm.generated.h"
+
+struct FStreamableHandle;
+
+/*
+ * a group of assets that gets loaded together, cf. `UMyAssetPrewarm`
+ */
+USTRUCT()
+struct FPrewarmBundle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	FName Name;
+
+	// higher loads first, cf. `FStreamableManager::AsyncLoadHighPriority`
+	UPROPERTY(Config)
+	int32 Priority = 0;
+
+	// classes as "/Game/Path/BP_Name.BP_Name_C"; whatever they reference gets loaded, too
+	UPROPERTY(Config)
+	TArray<FSoftObjectPath> Assets;
+};
+
+/**
+ * Loads the assets of the first match (pawn, HUD) in the background while the main menu is idle, instead of while
+ * the level loads: the first host or join after launch would otherwise wait for them, later ones don't.
+ *
+ * Every entry of `Bundles` becomes a dynamic primary asset "Prewarm:<Name>" of the asset manager with an asset bundle
+ * "Game", loaded asynchronously with its own priority `StartDelay` seconds after the main menu is up. The handles keep
+ * the assets in memory for the lifetime of the game instance. `mp.Prewarm cancel` cancels what's still loading.
+ *
+ * To compare the stall of the first match with later ones, every level load (`PreLoadMap` to `PostLoadMap`) and the
+ * longest frame during the `HitchWindow` seconds after it get recorded; `mp.Prewarm` logs them together with the
+ * state of every bundle. `-NoPrewarm` turns pre-warming off, for the comparison.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMyAssetPrewarm : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void StartPrewarm();
+	void CancelPrewarm();
+
+	void LogReport() const;
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UPROPERTY(Config)
+	TArray<FPrewarmBundle> Bundles;
+
+	// seconds the main menu has to be up before pre-warming starts, such that the menu itself comes up quickly
+	UPROPERTY(Config)
+	float StartDelay = 1.f;
+
+	UPROPERTY(Config)
+	float HitchWindow = 3.f;
+
+private:
+	void HandlePreLoadMap(const FString& MapName);
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+	bool Tick(float DeltaTime);
+
+	// "done" when all bundles are loaded, "off" when pre-warming didn't start yet
+	FString GetPrewarmState() const;
+
+	struct FBundleState
+	{
+		FName Name;
+		TSharedPtr<FStreamableHandle> Handle;
+		double StartTime = 0.;
+		double LoadSeconds = -1.;
+	};
+	TArray<FBundleState> States;
+
+	struct FLevelLoad
+	{
+		FString Map;
+		double LoadSeconds = 0.;
+		float MaxFrameMs = 0.f;
+		FString Prewarm;
+	};
+	TArray<FLevelLoad> LevelLoads;
+
+	bool bEnabled = true;
+	bool bStarted = false;
+	// counting down to the start, < 0 when not scheduled
+	float StartCountdown = -1.f;
+	double PreLoadMapTime = 0.;
+	// counting down the hitch window of `LevelLoads.Last()`
+	float HitchRemaining = 0.f;
+
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FTSTicker::FDelegateHandle TickHandle;
+};
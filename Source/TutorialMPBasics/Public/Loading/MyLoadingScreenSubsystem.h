@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Modes/MyGISubsystem.h"
+#include "MyLoadingScreenSubsystem.generated.h"
+
+class SMyLoadingScreen;
+
+/**
+ * Shows `SMyLoadingScreen` whenever the player has to wait.
+ *
+ * Map loads (`ServerTravel`, `ClientTravelToSession`) block the game thread, thus the loading screen is handed to the
+ * movie player, which renders it on its own thread until the new map is up. Login, session creation and session
+ * search are asynchronous and leave the game thread running; then the very same widget simply sits in the viewport.
+ */
+UCLASS()
+class TUTORIALMPBASICS_API UMyLoadingScreenSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	void HandlePreLoadMap(const FString& MapName);
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+	void HandleSessionStage(ESessionStage NewStage);
+
+	void ShowInViewport();
+	void HideFromViewport();
+
+	TSharedPtr<SMyLoadingScreen> LoadingScreen;
+	// the viewport holds the widget through this wrapper, cf. `ShowInViewport`
+	TSharedPtr<SWidget> ViewportContent;
+
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FDelegateHandle SessionStageHandle;
+};
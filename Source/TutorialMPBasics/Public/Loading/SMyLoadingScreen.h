@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Modes/MyGISubsystem.h"
+
+#include <atomic>
+
+/**
+ * The loading screen: what's going on (the session stage, the map being loaded) and how far along async loading is.
+ *
+ * During map loads this widget lives on the movie player's loading thread while the game thread is busy loading,
+ * thus it must not touch any UObject: everything it shows is either copied in on the game thread before (the stage
+ * names) or read from thread safe counters (the number of packages in flight).
+ */
+class TUTORIALMPBASICS_API SMyLoadingScreen : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SMyLoadingScreen) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
+	// game thread
+	void SetStage(ESessionStage NewStage);
+	void SetMapName(const FString& NewMapName);
+
+private:
+	FText GetStageText() const;
+	FText GetProgressText() const;
+	TOptional<float> GetProgress() const;
+
+	// the display names of `ESessionStage`, looked up once on the game thread
+	TArray<FText> StageTexts;
+	std::atomic<uint8> Stage{0};
+
+	mutable FCriticalSection MapNameLock;
+	FText MapText;
+
+	// sampled every `SampleInterval` seconds on whatever thread ticks us
+	static constexpr float SampleInterval = 0.1f;
+	float TimeSinceSample = SampleInterval;
+	int32 PendingPackages = 0;
+	int32 PeakPendingPackages = 0;
+};
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed-point number with 16 fractional bits in an int64: range about +-1.4e14, resolution 1/65536.
+ *
+ * Lockstep peers have to compute bit-identical results. Floating point doesn't guarantee that across compilers,
+ * instruction sets and optimization levels (fused multiply-add, x87 vs. SSE, reassociation), integer arithmetic does.
+ * Right shifts of negative numbers are arithmetic on every compiler Unreal supports.
+ */
+struct FFixed
+{
+	static constexpr int32 FractionBits = 16;
+	static constexpr int64 One = int64(1) << FractionBits;
+
+	int64 Raw = 0;
+
+	static constexpr FFixed FromRaw(int64 InRaw)
+	{
+		FFixed Fixed;
+		Fixed.Raw = InRaw;
+		return Fixed;
+	}
+
+	static constexpr FFixed FromInt(int64 Value)
+	{
+		return FromRaw(Value * One);
+	}
+
+	// `Numerator / Denominator`, exact up to the resolution
+	static constexpr FFixed FromRatio(int64 Numerator, int64 Denominator)
+	{
+		return FromRaw(Numerator * One / Denominator);
+	}
+
+	// for display only, never feed the result back into the simulation
+	float ToFloat() const
+	{
+		return static_cast<float>(static_cast<double>(Raw) / One);
+	}
+
+	FFixed operator+(FFixed Other) const { return FromRaw(Raw + Other.Raw); }
+	FFixed operator-(FFixed Other) const { return FromRaw(Raw - Other.Raw); }
+	FFixed operator-() const { return FromRaw(-Raw); }
+	FFixed operator*(FFixed Other) const { return FromRaw((Raw * Other.Raw) >> FractionBits); }
+	FFixed operator/(FFixed Other) const { return FromRaw((Raw << FractionBits) / Other.Raw); }
+	FFixed& operator+=(FFixed Other) { Raw += Other.Raw; return *this; }
+	FFixed& operator-=(FFixed Other) { Raw -= Other.Raw; return *this; }
+
+	bool operator==(FFixed Other) const { return Raw == Other.Raw; }
+	bool operator!=(FFixed Other) const { return Raw != Other.Raw; }
+	bool operator<(FFixed Other) const { return Raw < Other.Raw; }
+	bool operator>(FFixed Other) const { return Raw > Other.Raw; }
+
+	friend FArchive& operator<<(FArchive& Ar, FFixed& Fixed)
+	{
+		return Ar << Fixed.Raw;
+	}
+};
+
+struct FFixedVector
+{
+	FFixed X;
+	FFixed Y;
+	FFixed Z;
+
+	FFixedVector operator+(const FFixedVector& Other) const { return {X + Other.X, Y + Other.Y, Z + Other.Z}; }
+	FFixedVector operator*(FFixed Scale) const { return {X * Scale, Y * Scale, Z * Scale}; }
+	FFixedVector& operator+=(const FFixedVector& Other) { X += Other.X; Y += Other.Y; Z += Other.Z; return *this; }
+
+	FVector ToVector() const
+	{
+		return FVector(X.ToFloat(), Y.ToFloat(), Z.ToFloat());
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FFixedVector& Vector)
+	{
+		return Ar << Vector.X << Vector.Y << Vector.Z;
+	}
+};
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Lockstep/FixedPoint.h"
+#include "LockstepSim.generated.h"
+
+UENUM()
+enum class ELockstepCommand : uint8
+{
+	Join,
+	Leave,
+	Left,
+	Right
+};
+
+// something a player did, scheduled for a specific tick by the host
+USTRUCT()
+struct FLockstepCommand
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 PlayerId = 0;
+
+	UPROPERTY()
+	ELockstepCommand Command = ELockstepCommand::Join;
+};
+
+// all commands of one tick, in the order the host received them; usually empty
+USTRUCT()
+struct FLockstepFrame
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Tick = 0;
+
+	UPROPERTY()
+	TArray<FLockstepCommand> Commands;
+};
+
+/**
+ * The pawn simulation of the lockstep mode, cf. `UMyLockstepSubsystem`: plain data, fixed-point arithmetic, no
+ * dependency on anything but its own state and the frames fed into it. Stepping two copies of it with the same frames
+ * yields bit-identical states, which `GetChecksum` verifies.
+ *
+ * Entities are the pawns of the players plus `NumBots` bots that steer by a random generator, which is part of the
+ * state, too.
+ */
+class TUTORIALMPBASICS_API FLockstepSim
+{
+public:
+	struct FEntity
+	{
+		// INDEX_NONE for bots
+		int32 PlayerId = INDEX_NONE;
+		FFixedVector Position;
+		FFixedVector Velocity;
+	};
+
+	void Init(int32 InTickRate, int32 NumBots, uint32 Seed);
+
+	// advances by one tick, `Frame.Tick` has to be `GetTick() + 1`
+	void Step(const FLockstepFrame& Frame);
+
+	int32 GetTick() const
+	{
+		return Tick;
+	}
+
+	const TArray<FEntity>& GetEntities() const
+	{
+		return Entities;
+	}
+
+	uint32 GetChecksum() const;
+
+	// complete state, for late joiners
+	void Save(TArray<uint8>& OutBytes) const;
+	bool Load(const TArray<uint8>& Bytes);
+
+private:
+	void Serialize(FArchive& Ar);
+	uint32 NextRandom();
+	int32 FindPlayer(int32 PlayerId) const;
+
+	int32 Tick = 0;
+	int32 TickRate = 20;
+	uint32 RandomState = 1;
+	TArray<FEntity> Entities;
+};
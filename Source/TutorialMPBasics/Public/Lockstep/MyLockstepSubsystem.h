@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Lockstep/LockstepSim.h"
+#include "Modes/MyPlayerController.h"
+#include "MyLockstepSubsystem.generated.h"
+
+class AMyPawn;
+
+/**
+ * Lockstep mode, an alternative to replicating the pawns: start the host with `-Lockstep`.
+ *
+ * A pawn's state is fully determined by where it started and the `EAction`s of its player. Thus instead of the pawns,
+ * only the actions get sent: the host collects them into one `FLockstepFrame` per tick (`TickRate` per second) and
+ * sends every frame to every client; host and clients feed the frames into their own `FLockstepSim`. Bandwidth grows
+ * with the number of players (and how busy they are), not with the number of pawns: `Bots` adds pawns that cost
+ * nothing on the wire.
+ * The pawns that get drawn are local, non-replicated `AMyPawn` actors placed from the simulation every frame, the game
+ * mode doesn't spawn any.
+ *
+ * Every `ChecksumInterval` ticks, clients send a checksum of their simulation state. The host compares it to its own
+ * state at that tick, logs a desync and resynchronizes the client.
+ *
+ * Every `SnapshotInterval` ticks, the host saves the state and keeps the frames from then on. A joining client gets
+ * snapshot and frames and fast-forwards to the present.
+ *
+ * `mp.Lockstep` logs tick, entities, bandwidth and checksum statistics.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMyLockstepSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// host: lockstep mode is requested, thus the game mode hands players over to us instead of spawning pawns
+	bool IsLockstepHost() const;
+
+	// host, called by the game mode
+	void AddPlayer(AMyPlayerController* PC);
+	void RemovePlayer(AMyPlayerController* PC);
+
+	// host: schedule an action of `PC` for the next tick
+	void SubmitAction(const AMyPlayerController* PC, EAction Action);
+
+	// client, received by the player controller
+	void ReceiveSnapshot(int32 TotalSize, const TArray<uint8>& Chunk);
+	void ReceiveFrame(const FLockstepFrame& Frame);
+
+	// host, received by the player controller
+	void ReceiveChecksum(AMyPlayerController* PC, int32 Tick, uint32 Checksum);
+
+	void LogStats() const;
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// simulation ticks per second
+	UPROPERTY(Config)
+	int32 TickRate = 20;
+
+	// ticks between two checksums of a client
+	UPROPERTY(Config)
+	int32 ChecksumInterval = 20;
+
+	// ticks between two snapshots for joining clients, i.e. a joining client fast-forwards at most this many ticks
+	UPROPERTY(Config)
+	int32 SnapshotInterval = 100;
+
+	// host: number of bot pawns
+	UPROPERTY(Config)
+	int32 Bots = 0;
+
+	// host: a hitch doesn't make us step the simulation more than this often in one frame, we rather fall behind;
+	// clients: fast-forwarding happens in steps of this many ticks per frame
+	UPROPERTY(Config)
+	int32 MaxStepsPerFrame = 100;
+
+	// where simulation position 0 is in the level
+	UPROPERTY(Config)
+	FVector Origin = FVector::Zero();
+
+	// the pawns that get drawn, `Visuals[i]` shows `Sim.GetEntities()[i]`
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AMyPawn>> Visuals;
+
+private:
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void StartHost();
+	void StepHost(float DeltaSeconds);
+	void StepClient(float DeltaSeconds);
+
+	void SendSnapshot(AMyPlayerController* PC);
+	void UpdateVisuals();
+
+	// `-Lockstep`
+	bool bLockstepRequested = false;
+	// host: after the first player got added; client: after the first snapshot
+	bool bRunning = false;
+
+	FLockstepSim Sim;
+	FDelegateHandle WorldPostActorTickHandle;
+
+	// seconds since the last tick of `Sim`
+	float SinceStep = 0.f;
+
+	// host: the commands for the next tick
+	TArray<FLockstepCommand> PendingCommands;
+
+	// host: the clients that receive frames
+	TArray<TWeakObjectPtr<AMyPlayerController>> Peers;
+
+	// host: the state at `SnapshotTick` and all frames since then
+	TArray<uint8> Snapshot;
+	TArray<FLockstepFrame> FramesSinceSnapshot;
+
+	// host: our own checksums of the recent past, by tick
+	TMap<int32, uint32> Checksums;
+
+	// client: frames that arrived but haven't been stepped yet, and a snapshot that is still arriving
+	TArray<FLockstepFrame> PendingFrames;
+	TArray<uint8> IncomingSnapshot;
+
+	// statistics
+	int32 FramesSent = 0;
+	int64 BytesSent = 0;
+	int32 ChecksumsCompared = 0;
+	int32 Desyncs = 0;
+	int32 SnapshotsSent = 0;
+	double LastStepTime = 0.;
+};
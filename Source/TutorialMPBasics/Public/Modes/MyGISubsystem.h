@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
 #include "Interfaces/OnlineSessionInterface.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Modes/MyLocalPlayer.h"
@@ -11,6 +12,33 @@
 
 #define SETTING_CUSTOMNAME FName(TEXT("CUSTOMNAME"))
 #define SETTING_LEVEL FName(TEXT("LEVEL"))
+// set by a host that is shutting down, cf. `UMyServerDrain`
+#define SETTING_DRAINING FName(TEXT("DRAINING"))
+// live advertisement of the host, cf. `UMySessionAdvertiser`
+#define SETTING_NUMPLAYERS FName(TEXT("NUMPLAYERS"))
+#define SETTING_LOAD FName(TEXT("LOAD"))
+
+/*
+ * the stages of the session lifecycle, as far as this local game instance is concerned;
+ * any interested party (benchmarks, loading screen) can follow along via `UMyGISubsystem::OnSessionStage`
+ */
+UENUM(BlueprintType)
+enum class ESessionStage : uint8
+{
+	None      UMETA(DisplayName="none"),
+	LoggingIn UMETA(DisplayName="logging in"),
+	Creating  UMETA(DisplayName="creating session"),
+	Created   UMETA(DisplayName="session created"),
+	Searching UMETA(DisplayName="searching sessions"),
+	Found     UMETA(DisplayName="session found"),
+	Joining   UMETA(DisplayName="joining session"),
+	Joined    UMETA(DisplayName="session joined"),
+	Leaving   UMETA(DisplayName="leaving session"),
+	Left      UMETA(DisplayName="session left"),
+	Failed    UMETA(DisplayName="failed")
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSessionStage, ESessionStage);
 
 /**
  * 
@@ -25,14 +53,71 @@ public:
 	void JoinSession(const FLocalPlayerContext& LPC, TFunction<void(ECurrentLevel, EOnJoinSessionCompleteResult::Type)> Callback);
 
 	void LeaveSession();
+
+	bool HasSession() const;
+
+	// change the settings of the current session and publish them; false if there is no session
+	bool UpdateSession(TFunctionRef<void(FOnlineSessionSettings&)> Edit);
 	
 	// show the login browser window for EOS
 	void ShowLoginScreen(const FLocalPlayerContext& LPC);
+
+	// the stage of the local player that creates or joins sessions
+	ESessionStage GetSessionStage() const
+	{
+		return SessionStage;
+	}
+
+	// Split screen: the stage of any local player. The one that creates or joins (the session owner) goes through all
+	// stages; the others only get registered with the session once the owner is in (`Joining`, `Joined`), they play
+	// over the connection of the owner.
+	ESessionStage GetSessionStage(const ULocalPlayer* LocalPlayer) const;
+
+	// fires whenever `SessionStage` changes
+	FOnSessionStage OnSessionStage;
+
+	// Number of the create/find/join/destroy delegates of the session interface that have any binding left. We bind
+	// them with every call and remove our bindings once the session has been left, thus this has to be 0 then, after
+	// any number of host/join/leave cycles. Otherwise, delegates leak.
+	int32 GetNumBoundSessionDelegates() const;
 	
 protected:
 	// event handlers
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 
 private:
 	IOnlineSessionPtr GetSessionInterface() const;
+
+	// the online subsystem used when not in LAN mode: EOS, or MOCK with `-MockOnline`
+	static FName GetOnlineServiceName();
+
+	// of the session owner
+	void SetSessionStage(ESessionStage NewStage);
+	void SetLocalPlayerStage(int32 ControllerId, ESessionStage NewStage);
+
+	// once the session owner created or joined: register the other local players with the session
+	void RegisterSplitscreenPlayers();
+
+	// removes our bindings of the session interface delegates, cf. `GetNumBoundSessionDelegates`
+	void UnbindSessionDelegates();
+
+	// end of `LeaveSession`: session destroyed (`Left`) or not (`Failed`)
+	void FinishLeaveSession(bool bLeft);
+
+	// `LeaveSession` waits for `DestroySession` to complete
+	bool bDestroyPending = false;
+	FTSTicker::FDelegateHandle DestroySessionTimeoutTicker;
+
+	FDelegateHandle CreateSessionCompleteHandle;
+	FDelegateHandle FindSessionsCompleteHandle;
+	FDelegateHandle JoinSessionCompleteHandle;
+	FDelegateHandle DestroySessionCompleteHandle;
+
+	ESessionStage SessionStage = ESessionStage::None;
+
+	// controller id of the local player that created or joined the session
+	int32 SessionOwnerId = INDEX_NONE;
+	// by controller id, the session owner included
+	TMap<int32, ESessionStage> LocalPlayerStages;
 };
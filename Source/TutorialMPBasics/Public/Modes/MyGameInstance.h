@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/GameInstance.h"
+#include "Modes/MyLocalPlayer.h"
 #include "MyGameInstance.generated.h"
 
 /*
@@ -60,12 +61,22 @@ public:
 	// well for this example
 	void JoinGame(const FLocalPlayerContext& LPC);
 
-	// the `NetMulticast` turns this function into a multicast RPC
-	// cf. https://docs.unrealengine.com/5.0/en-US/rpcs-in-unreal-engine/
-	// Conveniently, called from the server, it will get executed right there plus on all connected clients.
-	// And when called on some client, it will get executed locally.
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastRPC_LeaveSession();
+	// Leave the current session. A client simply leaves. The host of a session with clients drains it first: the
+	// clients get told to leave, spread over several frames, and the session ends when they are gone, cf.
+	// `UMyServerDrain`.
+	// (This used to be a `NetMulticast` RPC. RPCs only work on replicated actors and their components, though; on the
+	// game instance, it just ran locally and the clients lost their connection when the host's session went away.)
+	UFUNCTION()
+	void LeaveSession();
+
+	// Split screen: add a local player on the next free controller, or remove the one added last; only in the main
+	// menu. The local players then host or join together: the additional ones play over the connection of the first
+	// one (child connections), thus every replicated actor gets sent once per machine instead of once per player.
+	// Console: `mp.Splitscreen.Add`, `mp.Splitscreen.Remove`.
+	void AddSplitscreenPlayer();
+	void RemoveSplitscreenPlayer();
+
+	static constexpr int32 MaxLocalPlayers = 4;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	FHostSessionConfig SessionConfig =
@@ -81,4 +92,8 @@ protected:
 
 	// Using Local Player for player-specific application state requires some initialization we will do here
 	virtual int32 AddLocalPlayer(ULocalPlayer* NewPlayer, int32 ControllerId) override;
+
+private:
+	// of all local players, they travel together
+	void SetCurrentLevel(ECurrentLevel NewLevel);
 };
@@ -6,6 +6,8 @@
 #include "GameFramework/GameModeBase.h"
 #include "MyGameModeBase.generated.h"
 
+class AMyPawn;
+
 /**
  * 
  */
@@ -14,13 +16,59 @@ class TUTORIALMPBASICS_API AMyGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
 
+public:
+	// Pawn pool: with many players joining and leaving, spawning and destroying pawns all the time implies
+	// allocation spikes (every pawn comes with its components, which need to be registered) and garbage collection
+	// churn. Instead, pawns get handed out from a pool and are put back into it when their player leaves.
+
+	// returns a pooled pawn of exactly the class `PawnClass`, or `nullptr` if there is none (a pool miss)
+	AMyPawn* AcquirePawn(UClass* PawnClass, const FTransform& SpawnTransform);
+
+	// reset and hide `Pawn` and put it back into the pool, the pawn must not be possessed anymore
+	void ReleasePawn(AMyPawn* Pawn);
+
 protected:
+	// number of pawns that get spawned (hidden) when the level starts;
+	// set this in "BP_MyGameModeBase" or in the game mode override of a specific level
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 PawnPoolPrewarmCount = 8;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly)
+	TArray<TObjectPtr<AMyPawn>> PawnPool;
+
 	// event handlers
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	
+	// rejects everybody while the server drains, cf. `UMyServerDrain`
+	virtual void PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage) override;
 	virtual void PostLogin(APlayerController* NewPlayer) override;
+	virtual void Logout(AController* Exiting) override;
+
+	// no pawns in lockstep mode, cf. `UMyLockstepSubsystem`
+	virtual bool PlayerCanRestart_Implementation(APlayerController* Player) override;
 
 	// The Unreal default mechanism for choosing a player start seems broken
 	// cf. https://forums.unrealengine.com/t/playerstart-actors-for-multiplayer-disfunct-or-what-am-i-doing-wrong/681970
 	// (In principle, it allows to spawn actors in a randomly chosen player start, where a collision is
 	// handled depending on the "Spawn collision handling method" of the PlayerStart actor)
 	virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
+
+	// the default implementation spawns a new pawn; we try the pool first
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+private:
+	// pool statistics for the current level, logged in `EndPlay`
+	int32 PawnPoolHits = 0;
+	int32 PawnPoolMisses = 0;
+
+	// garbage collection timing, to see whether pooling actually pays off
+	void HandlePreGarbageCollect();
+	void HandlePostGarbageCollect();
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+	double GarbageCollectStartTime = 0.;
+	double GarbageCollectTotalTime = 0.;
+	int32 GarbageCollectCount = 0;
 };
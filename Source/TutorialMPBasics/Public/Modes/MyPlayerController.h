@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "Lockstep/LockstepSim.h"
 #include "MyPlayerController.generated.h"
 
 /*
@@ -25,19 +26,64 @@ class TUTORIALMPBASICS_API AMyPlayerController : public APlayerController
 	GENERATED_BODY()
 
 	virtual void SetupInputComponent() override;
+
+	virtual void BeginPlay() override;
 	
 public:
 	UFUNCTION(Client, Reliable)
 	void ClientRPC_LeaveSession();
+
+	// the host is shutting down and the session ends in `SecondsLeft`, cf. `UMyServerDrain`
+	UFUNCTION(Client, Reliable)
+	void ClientRPC_ServerDraining(float SecondsLeft);
+
+	// lockstep mode, cf. `UMyLockstepSubsystem`: the host sends the state and the frames, clients send checksums
+	UFUNCTION(Client, Reliable)
+	void ClientRPC_LockstepSnapshot(int32 TotalSize, const TArray<uint8>& Chunk);
+
+	UFUNCTION(Client, Reliable)
+	void ClientRPC_LockstepFrame(const FLockstepFrame& Frame);
+
+	// losing one is fine, there's another one soon
+	UFUNCTION(Server, Unreliable)
+	void ServerRPC_LockstepChecksum(int32 Tick, uint32 Checksum);
+
+	// carry out an `EAction` on behalf of the local player, the same way a key press does
+	void PerformAction(EAction Action);
+
+	// seconds since the oldest action that hasn't been answered by the host yet, or -1 if there is none or if
+	// `AcknowledgedAction` (the sequence number the host carried out last) doesn't answer it yet;
+	// resets the measurement, cf. `AMyPawn::OnRep_LastAction`
+	double ConsumeActionRoundTrip(int32 AcknowledgedAction);
+	
 protected:
 	// locally carry out an `EAction`
 	void HandleAction(EAction Action) const;
 
+	// called on the host when this controller leaves the game; instead of destroying the pawn, we put it back into
+	// the pawn pool of `AMyGameModeBase`
+	virtual void PawnLeavingGame() override;
+
 private:
 	// bind an action and do the appropriate RPC, the action needs to be represented in the enum `EAction`
 	void BindActionWithRPC(const FName ActionName, EInputEvent KeyEvent, EAction Action);
 
 	// a simple wrapper around `HandleAction`, lifting it to the host, where it then gets executed locally
+	// `Sequence` numbers the actions of this client, the host acknowledges it via `AMyPawn::LastAction`
 	UFUNCTION(Server, Reliable)
-	void ServerRPC_HandleAction(EAction Action);
+	void ServerRPC_HandleAction(EAction Action, int32 Sequence);
+
+	// `ServerRPC_HandleAction` plus bookkeeping for `ConsumeActionRoundTrip`
+	void SendAction(EAction Action);
+
+	double ActionSentTime = -1.;
+	// the sequence number of the action sent at `ActionSentTime`
+	int32 MeasuredAction = INDEX_NONE;
+	int32 NextAction = 0;
+
+	// With `-BotInput` on the command line, the local player is replaced by a bot that randomly presses left and
+	// right. Used for headless load tests and benchmarks.
+	void BotAction();
+	
+	FTimerHandle BotInputTimer;
 };
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Modes/MyGISubsystem.h"
+#include "MySessionBenchmark.generated.h"
+
+/*
+ * latency budget for one stage of the session lifecycle
+ */
+USTRUCT()
+struct FSessionStageBudget
+{
+	GENERATED_BODY()
+
+	// "create", "find", "join", "travel" or "leave"
+	UPROPERTY(Config)
+	FString Stage;
+
+	UPROPERTY(Config)
+	float P95Ms = 0.f;
+};
+
+/**
+ * Session lifecycle benchmark: runs the session code of `UMyGameInstance` and `UMyGISubsystem` in a loop, the same
+ * way the main menu buttons do, and reports p50/p95/p99 latencies per stage. Meant for the NULL online subsystem on
+ * loopback with two processes, cf. "bench_sessions.sh":
+ *
+ * `-SessionBench=host`: create session, travel to the level, stay for `HostHoldSeconds`, leave, and again
+ * `-SessionBench=join`: find session, join, travel, stay for `JoinHoldSeconds`, leave, and again
+ *
+ * `-SessionBenchCycles=<n>` overrides `Cycles`. When done, the process quits with exit code 1 if any stage exceeded its
+ * budget in `Budgets` or if the delegates of the session interface leaked, 0 otherwise.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMySessionBenchmark : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UPROPERTY(Config)
+	int32 Cycles = 20;
+
+	UPROPERTY(Config)
+	float HostHoldSeconds = 8.f;
+
+	UPROPERTY(Config)
+	float JoinHoldSeconds = 2.f;
+
+	// a failed stage (e.g. no session found while the host is rehosting) gets retried after this delay
+	UPROPERTY(Config)
+	float RetrySeconds = 1.f;
+
+	UPROPERTY(Config)
+	TArray<FSessionStageBudget> Budgets;
+
+private:
+	enum class ERole : uint8
+	{
+		Host,
+		Join
+	};
+
+	void HandleSessionStage(ESessionStage Stage);
+	void HandlePostLoadMap(UWorld* World);
+
+	void StartCycle();
+	void Leave();
+	void Finish();
+
+	// run `Function` after `Delay` seconds, independently of any world (we travel a lot)
+	void RunAfter(float Delay, TFunction<void()> Function);
+
+	void StartStage(const FString& Stage);
+	void EndStage(const FString& Stage);
+
+	ERole Role = ERole::Host;
+	bool bFirstMapLoaded = false;
+	int32 CompletedCycles = 0;
+	int32 Failures = 0;
+
+	TMap<FString, double> StageStartTimes;
+	TMap<FString, TArray<float>> StageSamples;
+
+	// any session delegate still bound after a cycle, cf. `UMyGISubsystem::GetNumBoundSessionDelegates`
+	bool bDelegatesLeaked = false;
+
+	FDelegateHandle SessionStageHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FTSTicker::FDelegateHandle PendingTicker;
+};
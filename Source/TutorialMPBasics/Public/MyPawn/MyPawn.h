@@ -6,6 +6,22 @@
 #include "GameFramework/Pawn.h"
 #include "MyPawn.generated.h"
 
+/*
+ * the authoritative location of a pawn at some point in time (in seconds of the host's world time);
+ * the host replicates this regularly, thus clients can measure and correct their deviation
+ */
+USTRUCT()
+struct FPawnServerState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize Location = FVector::Zero();
+
+	UPROPERTY()
+	float ServerTime = 0.f;
+};
+
 UCLASS()
 class TUTORIALMPBASICS_API AMyPawn : public APawn
 {
@@ -31,12 +47,83 @@ public:
 	// "Modes/PlayerController.cpp".
 	// Note that movement replication is turned off. With the velocity replicated, the pawn has all the information
 	// required to correctly move in-sync.
+	// Never write to `Velocity` without `MarkVelocityDirty`, it's replicated using the push model.
 	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly)
 	FVector Velocity = FVector::Zero();
 
+	// The sequence number of the last action of the owning client the host has carried out, replicated to the owner
+	// only. `Velocity` also changes without any action (collisions), thus only this tells the client that its action
+	// made the round trip, cf. `AMyPlayerController::ConsumeActionRoundTrip`.
+	UPROPERTY(ReplicatedUsing=OnRep_LastAction)
+	int32 LastAction = INDEX_NONE;
+
+	// Only moving according to `Velocity`, the clients drift away from the host, e.g. when a velocity change
+	// arrives late because of lag. Every `mp.Pawn.ServerStateInterval` seconds, the host replicates the location
+	// of the pawn and a client corrects its location if it's off by more than `mp.Pawn.CorrectionThreshold`.
+	UPROPERTY(ReplicatedUsing=OnRep_ServerState)
+	FPawnServerState ServerState;
+
 	void AccelerateLeft();
 	void AccelerateRight();
+	void SetVelocity(const FVector& NewVelocity);
+	// host only
+	void AcknowledgeAction(int32 Sequence);
+
+	// Pooling, cf. `AMyGameModeBase::AcquirePawn` and `AMyGameModeBase::ReleasePawn`:
+	// Instead of being destroyed, a pawn that isn't needed anymore gets reset and parked in the pool of the game mode.
+	// A pooled pawn is hidden, doesn't collide and doesn't tick. Hidden without collision implies that the pawn isn't
+	// net relevant for any client, thus clients won't even know about pooled pawns.
+	void ActivateFromPool(const FTransform& SpawnTransform);
+	void DeactivateToPool();
+
+	bool IsPooled() const
+	{
+		return bPooled;
+	}
+
+	// false: the pawn stays out of `UMyPawnSubsystem`, i.e. no collisions, no lag compensation, no instanced rendering;
+	// for pawns that are only shown or measured (benchmarks, lockstep visuals); set it before `FinishSpawning`
+	bool bRegisterWithSubsystem = true;
+
+	// the radius of the collision sphere `Root`
+	float GetRadius() const;
+
+	UStaticMeshComponent* GetBody() const
+	{
+		return Body;
+	}
+
+	// Classic replication sorts the actors by priority, per connection, and replicates them in that order until the
+	// connection's byte budget for the frame is used up; the rest waits for the next frame, with a higher priority
+	// then, as this grows with the time since the last update. We scale the priority down with the distance to the
+	// viewer and up if `Velocity` changed recently: under bandwidth pressure, nearby and changing pawns get updated
+	// often, distant and steady ones rarely.
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
 
 	// event handlers
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
+
+protected:
+	UFUNCTION()
+	void OnRep_LastAction();
+
+	UFUNCTION()
+	void OnRep_ServerState();
+
+private:
+	bool bPooled = false;
+
+	// host only: time since `ServerState` has been updated
+	float ServerStateAge = 0.f;
+
+	// host only: world time of the last change of `Velocity`
+	float VelocityChangeTime = -1.f;
+
+	void MarkVelocityDirty();
+
+	// instance of the body in `AMyPawnInstanceRenderer`, if any
+	int32 InstanceIndex = INDEX_NONE;
+	friend class AMyPawnInstanceRenderer;
 };
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "MyPawnInstanceRenderer.generated.h"
+
+class AMyPawn;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Draws the bodies of all pawns of a world with a single instanced static mesh component, cf.
+ * `mp.Pawn.InstancedRendering`: one primitive and one batched transform update per frame instead of one primitive
+ * (with its own scene proxy and render transform update) per pawn.
+ *
+ * Every pawn handed to `AddPawn` gets an instance; its own `Body` gets unregistered, thus it has no render state
+ * anymore. Instances are dense: removing a pawn moves the last instance into the gap.
+ *
+ * Local only (never replicated), spawned and driven by `UMyPawnSubsystem`.
+ */
+UCLASS(Transient, NotPlaceable)
+class TUTORIALMPBASICS_API AMyPawnInstanceRenderer : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AMyPawnInstanceRenderer();
+
+	void AddPawn(AMyPawn* Pawn);
+	void RemovePawn(AMyPawn* Pawn);
+
+	// copies the transforms of all pawns into the instances, in one batch
+	void UpdateInstances();
+
+	int32 GetNumInstances() const
+	{
+		return Owners.Num();
+	}
+
+	// hands all pawns their bodies back
+	void RemoveAllPawns();
+
+protected:
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UInstancedStaticMeshComponent> Instances;
+
+private:
+	// the pawn of instance i is `Owners[i]`
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AMyPawn>> Owners;
+
+	TArray<FTransform> Transforms;
+};
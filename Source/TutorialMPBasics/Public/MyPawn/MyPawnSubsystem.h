@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyPawn/PawnHistory.h"
+#include "MyPawn/PawnSpatialHash.h"
+#include "MyPawnSubsystem.generated.h"
+
+class AMyPawn;
+class AMyPawnInstanceRenderer;
+
+/**
+ * Keeps track of all active pawns of a world (pooled pawns don't count), for anything that needs to work on all pawns
+ * at once every frame, without iterating all actors of the world.
+ *
+ * On the host, it records the history of all pawns after every frame for lag compensation: a client sees the world
+ * as it was about one round trip ago, thus any validation of what a client did has to happen against that past
+ * state, cf. `RewindOverlap`.
+ * `mp.PawnHistory` logs memory footprint and recording cost.
+ *
+ * `AMyPawn` moves without sweeping, thus pawns would pass through each other. After every frame, pawn-pawn
+ * collisions get resolved using a spatial hash over all pawn spheres (the physics scene isn't involved): overlapping
+ * pawns are pushed apart and, on the host, bounce off each other. `mp.Pawn.Collisions 0` turns this off,
+ * `mp.SpatialHashBench <pawn counts...>` compares the spatial hash with the engine's overlap queries.
+ *
+ * With `mp.Pawn.InstancedRendering 1`, the bodies of all pawns get drawn by one `AMyPawnInstanceRenderer`, updated
+ * in one batch after every frame. `mp.PawnRendering` logs primitive count and update cost,
+ * `mp.PawnRenderBench <pawn count> [<seconds>]` compares both modes (works headless, on host and client).
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMyPawnSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// called by `AMyPawn` when it becomes active or inactive (begin/end play, pooling)
+	void RegisterPawn(AMyPawn* Pawn);
+	void UnregisterPawn(AMyPawn* Pawn);
+
+	const TArray<TObjectPtr<AMyPawn>>& GetPawns() const
+	{
+		return Pawns;
+	}
+
+	// lag compensation, host only
+
+	// "now" as seen by the client of `Viewer`: server time minus the round trip time of its connection
+	double GetRewindTime(const AController* Viewer) const;
+
+	// where `Pawn` was at `Time`
+	bool RewindPawn(const AMyPawn* Pawn, double Time, FVector& OutLocation, float& OutRadius) const;
+
+	// all pawns that overlapped the sphere at `Center` with `Radius` from the point of view of `Viewer`
+	void RewindOverlap(const AController* Viewer, const FVector& Center, float Radius, TArray<AMyPawn*>& OutPawns) const;
+
+	void LogHistoryStats() const;
+
+	// neighbors: all pawns whose sphere overlaps the given sphere, as of the end of the last frame
+	void QueryOverlaps(const FVector& Center, float Radius, TArray<AMyPawn*>& OutPawns) const;
+
+	// spawns `Count` pawns at random, measures both kinds of overlap queries for each pawn and destroys the pawns
+	void RunSpatialHashBenchmark(int32 Count);
+
+	void SetInstancedRendering(bool bEnable);
+	void LogRenderStats() const;
+
+	// spawns `Count` moving pawns, renders them for `Seconds` without and `Seconds` with instancing, logs the numbers
+	// of both runs and destroys the pawns
+	void StartRenderBenchmark(int32 Count, float Seconds);
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// number of frames in the history; at 60 frames per second, 128 frames cover round trips of up to two seconds
+	UPROPERTY(Config)
+	int32 HistoryFrames = 128;
+
+	// pawns beyond this number don't get lag compensation
+	UPROPERTY(Config)
+	int32 HistoryMaxPawns = 256;
+
+	// cell size of the spatial hash; 0 means: the largest pawn diameter
+	UPROPERTY(Config)
+	float SpatialHashCellSize = 0.f;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AMyPawn>> Pawns;
+
+	UPROPERTY(Transient)
+	TObjectPtr<AMyPawnInstanceRenderer> InstanceRenderer;
+
+private:
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void BuildSpatialHash();
+	void ResolveCollisions();
+
+	FPawnSpatialHash SpatialHash;
+	// `SpatialHash` was built from these, `Pawns[i]` is `Spheres[i]`
+	TArray<FVector4f> Spheres;
+	// `Pawns` as of the build; `UnregisterPawn` reorders `Pawns` and clears the pawn's entry here, thus hash indices
+	// stay valid until the next build
+	TArray<AMyPawn*> SpatialHashPawns;
+
+	// history slot of `Pawns[i]` is `PawnSlots[i]`
+	TArray<int32> PawnSlots;
+	// and the other way round
+	TArray<AMyPawn*> SlotOwners;
+
+	TUniquePtr<FPawnHistory> History;
+	// the warning about pawns beyond `HistoryMaxPawns` has been logged
+	bool bWarnedHistoryFull = false;
+
+	FDelegateHandle WorldPostActorTickHandle;
+
+	double LastRecordTime = 0.;
+	double MaxRecordTime = 0.;
+
+	// number of primitive components of this world that have a render state, i.e. a scene proxy
+	int32 CountScenePrimitives() const;
+	void TickRenderBenchmark();
+
+	double LastInstanceUpdateTime = 0.;
+
+	struct FRenderBenchmark
+	{
+		TArray<TWeakObjectPtr<AMyPawn>> Pawns;
+		float Seconds = 0.f;
+		// 0: components, 1: instanced
+		int32 Run = 0;
+		double RunEndTime = 0.;
+		int32 Frames = 0;
+		double FrameTime = 0.;
+		double UpdateTime = 0.;
+		FString Results[2];
+	};
+	TUniquePtr<FRenderBenchmark> RenderBenchmark;
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Ring buffer of timestamped pawn spheres (location plus radius) for server-side rewind ("lag compensation").
+ *
+ * Memory is allocated once: `NumFrames` rows of `MaxPawns` samples each. A row holds all pawns of one frame
+ * contiguously, thus recording a frame and testing all pawns at some point in time both walk linear memory.
+ * A pawn owns a slot, i.e. a column; slots are recycled when pawns go away.
+ */
+class TUTORIALMPBASICS_API FPawnHistory
+{
+public:
+	FPawnHistory(int32 InNumFrames, int32 InMaxPawns);
+
+	// returns `INDEX_NONE` when all slots are taken
+	int32 AddPawn();
+	// forgets everything recorded for `Slot`, such that the next owner of the slot doesn't inherit its history
+	void RemovePawn(int32 Slot);
+
+	// start a new row, overwriting the oldest one; every slot that doesn't get recorded is invalid in that row
+	void BeginFrame(double Time);
+	void Record(int32 Slot, const FVector& Location, float Radius);
+
+	// the sphere of `Slot` at `Time`, interpolated between the two rows that enclose `Time`;
+	// `Time` gets clamped to the recorded time span
+	bool Rewind(int32 Slot, double Time, FVector& OutLocation, float& OutRadius) const;
+
+	// all slots whose sphere overlapped the given sphere at `Time`
+	void RewindOverlap(double Time, const FVector& Center, float Radius, TArray<int32>& OutSlots) const;
+
+	double GetOldestTime() const;
+
+	int32 GetMaxPawns() const
+	{
+		return MaxPawns;
+	}
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// finds the rows `Older` and `Newer` with `Time` in between, `Alpha` is the interpolation factor;
+	// false if nothing has been recorded yet
+	bool FindRows(double Time, int32& Older, int32& Newer, float& Alpha) const;
+
+	static bool IsValid(const FVector4f& Sample)
+	{
+		return Sample.W >= 0.f;
+	}
+
+	const FVector4f& Sample(int32 Row, int32 Slot) const
+	{
+		return Samples[Row * MaxPawns + Slot];
+	}
+
+	int32 NumFrames;
+	int32 MaxPawns;
+
+	// location in XYZ, radius in W; a negative radius marks an invalid sample
+	TArray<FVector4f> Samples;
+	TArray<double> FrameTimes;
+
+	// the row that has been written last
+	int32 Head = INDEX_NONE;
+	int32 NumRecorded = 0;
+
+	TArray<int32> FreeSlots;
+};
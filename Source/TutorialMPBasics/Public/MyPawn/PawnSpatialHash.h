@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform grid over pawn spheres for neighbor and overlap queries.
+ *
+ * The grid is a hash table of cells: every sphere is put into the cell of its center, cells are chained through
+ * `Next` (no per-cell allocations). With a cell size of at least the largest radius, any sphere that can overlap
+ * a given sphere lives in the cells the query sphere touches or in their direct neighbors: 27 cells for a query
+ * sphere inside one cell, up to 64 when it crosses cell boundaries (with radii of at most half a cell). Thus a query
+ * costs roughly the same no matter how many pawns there are.
+ * Rebuilding is linear in the number of pawns and reuses its memory, thus rebuilding every frame is fine.
+ */
+class TUTORIALMPBASICS_API FPawnSpatialHash
+{
+public:
+	// `CellSize` <= 0: twice the largest radius; otherwise it must not be smaller than the largest radius
+	void Build(TArrayView<const FVector4f> InSpheres, float CellSize);
+
+	// indices of all spheres that overlap the given sphere
+	template<typename FAllocator>
+	void QueryOverlaps(const FVector& Center, float Radius, TArray<int32, FAllocator>& OutIndices) const
+	{
+		Query(FVector3f(Center), Radius, OutIndices);
+	}
+
+	// calls `Visit(i, j)` for every overlapping pair with i < j
+	template<typename FVisit>
+	void ForEachOverlappingPair(FVisit Visit) const
+	{
+		TArray<int32, TInlineAllocator<32>> Overlaps;
+		for(int32 i = 0; i < Spheres.Num(); ++i)
+		{
+			Overlaps.Reset();
+			Query(FVector3f(Spheres[i]), Spheres[i].W, Overlaps);
+			for(const int32 j : Overlaps)
+			{
+				if(j > i)
+				{
+					Visit(i, j);
+				}
+			}
+		}
+	}
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	template<typename FAllocator>
+	void Query(const FVector3f& Center, float Radius, TArray<int32, FAllocator>& OutIndices) const;
+
+	FIntVector ToCell(const FVector3f& Location) const
+	{
+		return FIntVector
+			( FMath::FloorToInt(Location.X * InvCellSize)
+			, FMath::FloorToInt(Location.Y * InvCellSize)
+			, FMath::FloorToInt(Location.Z * InvCellSize)
+			);
+	}
+
+	int32 Bucket(const FIntVector& Cell) const
+	{
+		// the usual large primes for spatial hashing
+		const uint32 Hash = (Cell.X * 73856093u) ^ (Cell.Y * 19349663u) ^ (Cell.Z * 83492791u);
+		return Hash & (Buckets.Num() - 1);
+	}
+
+	float InvCellSize = 1.f;
+
+	// copy of the input, location in XYZ, radius in W
+	TArray<FVector4f> Spheres;
+	TArray<FIntVector> Cells;
+	// first sphere per bucket and next sphere in the same bucket, or INDEX_NONE
+	TArray<int32> Buckets;
+	TArray<int32> Next;
+};
+
+template<typename FAllocator>
+void FPawnSpatialHash::Query(const FVector3f& Center, float Radius, TArray<int32, FAllocator>& OutIndices) const
+{
+	if(Spheres.IsEmpty())
+	{
+		return;
+	}
+	const FIntVector Min = ToCell(Center - FVector3f(Radius));
+	const FIntVector Max = ToCell(Center + FVector3f(Radius));
+	// a sphere in a neighboring cell may reach into our range by its own radius, which is at most a cell
+	for(int32 X = Min.X - 1; X <= Max.X + 1; ++X)
+	for(int32 Y = Min.Y - 1; Y <= Max.Y + 1; ++Y)
+	for(int32 Z = Min.Z - 1; Z <= Max.Z + 1; ++Z)
+	{
+		const FIntVector Cell(X, Y, Z);
+		for(int32 i = Buckets[Bucket(Cell)]; i != INDEX_NONE; i = Next[i])
+		{
+			// different cells can end up in the same bucket
+			if(Cells[i] != Cell)
+			{
+				continue;
+			}
+			const FVector4f& S = Spheres[i];
+			const float R = S.W + Radius;
+			if(FVector3f::DistSquared(FVector3f(S), Center) <= R * R)
+			{
+				OutIndices.Add(i);
+			}
+		}
+	}
+}
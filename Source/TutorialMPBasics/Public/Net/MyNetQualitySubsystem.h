@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MyNetQualitySubsystem.generated.h"
+
+class UNetConnection;
+
+/**
+ * Network emulation profiles and netcode quality measurement.
+ *
+ * A profile is a section `[PacketSimulationProfile.<Name>]` in "DefaultEngine.ini": latency, jitter (the range
+ * between `PktLagMin` and `PktLagMax`) and loss are applied by the engine's packet simulation, `MaxBytesPerSecond` is
+ * applied by us as net speed of every connection; a profile without it (or `Off`) gives every connection back the net
+ * speed it had before.
+ * Apply a profile with `-NetProfile=<Name>` on the command line or `mp.NetProfile <Name>` in the console,
+ * `mp.NetProfile Off` turns emulation off again.
+ *
+ * `mp.NetQualityMatrix [seconds per profile]` on a connected client (or `-NetQualityMatrix` on the command line)
+ * runs through all `MatrixProfiles`, pressing random keys, and logs a table with position error, position
+ * corrections and input latency per profile. Cf. "quality_matrix.bat".
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMyNetQualitySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void ApplyNetProfile(const FString& ProfileName);
+
+	void StartQualityMatrix(float SecondsPerProfile);
+
+	// samples, recorded by `AMyPawn`
+	void RecordPositionError(float Error, bool bCorrected);
+	void RecordInputLatency(double Seconds);
+
+protected:
+	// event handlers
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// the profiles that `mp.NetQualityMatrix` runs through, in order
+	UPROPERTY(Config)
+	TArray<FString> MatrixProfiles;
+
+	// seconds per profile for `-NetQualityMatrix`
+	UPROPERTY(Config)
+	float MatrixSecondsPerProfile = 30.f;
+
+private:
+	// applies the bandwidth cap to connections that didn't exist when the profile got applied
+	bool Tick(float DeltaTime);
+	void ApplyNetSpeed();
+	void RestoreNetSpeed();
+
+	void StartMatrixProfile();
+	void FinishMatrixProfile();
+	void LogMatrix() const;
+
+	FTSTicker::FDelegateHandle TickHandle;
+
+	FString CurrentProfile = TEXT("Off");
+	int32 MaxBytesPerSecond = 0;
+	// net speed of every connection before `ApplyNetSpeed` capped it first
+	TMap<TWeakObjectPtr<UNetConnection>, int32> SavedNetSpeeds;
+
+	struct FMatrixRow
+	{
+		FString Profile;
+		TArray<float> PositionErrors;
+		int32 Corrections = 0;
+		TArray<float> InputLatencies;
+	};
+
+	// the row that is currently being recorded; samples are always recorded, even without a matrix run
+	FMatrixRow Current;
+	TArray<FMatrixRow> Matrix;
+
+	bool bMatrixRunning = false;
+	// with `-NetQualityMatrix`, we quit when done
+	bool bQuitAfterMatrix = false;
+	int32 MatrixIndex = 0;
+	float MatrixProfileSeconds = 0.f;
+	float MatrixProfileRemaining = 0.f;
+	float MatrixActionCooldown = 0.f;
+};
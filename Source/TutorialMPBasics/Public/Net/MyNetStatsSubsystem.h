@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyNetStatsSubsystem.generated.h"
+
+class UNetConnection;
+
+/**
+ * Measures what replication costs the host: CPU time spent in the net driver's tick flush (where actors get
+ * replicated and RPCs get sent) and bandwidth.
+ * Type `mp.NetStats` into the console for a report, `mp.NetStats.Reset` to start over.
+ *
+ * Per client connection, it samples once per second how much of the connection's byte budget (its net speed, cf.
+ * `UMyServerGovernor::ConnectionBytesPerSecond`) got used and how many pawn updates were deferred: pawns whose
+ * channel hasn't replicated for more than two of their net update intervals, because higher priority actors used up
+ * the budget first, cf. `AMyPawn::GetNetPriority`.
+ *
+ * With `-NetBench=<seconds>` on the command line, the host logs a single "NetBench" line after that many seconds
+ * and quits, cf. "bench_replication.bat"
+ */
+UCLASS()
+class TUTORIALMPBASICS_API UMyNetStatsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void LogReport() const;
+	void Reset();
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+private:
+	// The world broadcasts `OnTickFlush` right before the net driver replicates (the net driver itself is bound to
+	// that very delegate) and `OnPostTickFlush` afterwards.
+	// Multicast delegates broadcast in reverse order of binding, i.e. our handler, bound after the net driver's,
+	// runs first.
+	void HandleTickFlush(float DeltaSeconds);
+	void HandlePostTickFlush(float DeltaSeconds);
+
+	void HandleBenchmarkEnd();
+
+	FDelegateHandle TickFlushHandle;
+	FDelegateHandle PostTickFlushHandle;
+
+	double TickFlushStartTime = 0.;
+	double LastBandwidthSampleTime = 0.;
+
+	// one sample per frame, in milliseconds
+	TArray<float> ReplicationTimes;
+	// one sample per second, in bytes per second
+	TArray<int32> OutBytesPerSecond;
+	TArray<int32> InBytesPerSecond;
+	int32 MaxClientConnections = 0;
+
+	struct FConnectionStats
+	{
+		FString Address;
+		// sums over all samples
+		double BudgetUse = 0.;
+		int64 DeferredUpdates = 0;
+		int32 MaxDeferredUpdates = 0;
+		int32 Samples = 0;
+	};
+	void SampleConnections(const class UNetDriver& NetDriver);
+	TMap<TWeakObjectPtr<UNetConnection>, FConnectionStats> ConnectionStats;
+
+	FTimerHandle BenchmarkTimer;
+};
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyServerDrain.generated.h"
+
+class UNetConnection;
+
+/**
+ * Graceful shutdown of a hosted session, e.g. for rolling restarts of dedicated servers (`mp.Drain [seconds]` in the
+ * server console) or when the host of a listen server leaves (Escape).
+ *
+ * Draining means:
+ * - no new logins, cf. `AMyGameModeBase::PreLogin`
+ * - the session isn't advertised anymore and is flagged `SETTING_DRAINING`
+ * - every client gets told to leave (`AMyPlayerController::ClientRPC_ServerDraining`), `NoticesPerFrame` per frame
+ *   instead of all at once, such that neither the host nor the clients see a spike; the clients leave by themselves
+ * - once all clients are gone, or at the latest after the deadline, the session gets destroyed; connections still
+ *   open at the deadline get closed, `ClosesPerFrame` per frame
+ *
+ * A dedicated server quits when drained (`bExitWhenDrained`), a listen server returns to the main menu.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMyServerDrain : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// host only; `Seconds` until the deadline, <= 0 for `DrainSeconds`
+	void StartDrain(float Seconds = 0.f);
+
+	bool IsDraining() const
+	{
+		return bDraining;
+	}
+
+	// connections of clients that are still open
+	int32 GetNumClients() const;
+
+	void LogState() const;
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// default time between the start of the drain and tearing down the session
+	UPROPERTY(Config)
+	float DrainSeconds = 30.f;
+
+	UPROPERTY(Config)
+	int32 NoticesPerFrame = 8;
+
+	UPROPERTY(Config)
+	int32 ClosesPerFrame = 8;
+
+	UPROPERTY(Config)
+	bool bExitWhenDrained = true;
+
+private:
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void SendNotices();
+	void CloseConnections();
+	void TearDown();
+
+	FDelegateHandle WorldPostActorTickHandle;
+
+	bool bDraining = false;
+	bool bTornDown = false;
+	double StartTime = 0.;
+	double Deadline = 0.;
+
+	// connections that got the notice already
+	TSet<TWeakObjectPtr<UNetConnection>> Notified;
+	int32 NumClosed = 0;
+};
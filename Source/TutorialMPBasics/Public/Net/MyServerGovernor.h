@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyServerGovernor.generated.h"
+
+class UNetConnection;
+
+/**
+ * Adapts the host's net tick rate and the net update frequency of the pawns to the current load.
+ *
+ * Instead of fixed engine defaults, the rates follow the number of connected clients: a session with two idle
+ * players uses the minimum rates (less CPU on shared hosts), a full session the maximum ones. The load is the frame
+ * time relative to a fixed budget, the frame time at `MaxTickRate`. On a dedicated server, when the load exceeds
+ * `HighLoad`, the rates get lowered step by step (graceful degradation instead of missed frames) and they recover once
+ * there is headroom again.
+ *
+ * The net tick rate is the frame rate of a dedicated server, thus it's governed on dedicated servers only; the engine
+ * ignores it on a listen server (cf. `UGameEngine::GetMaxTickRate`), which ticks at the frame rate of its player.
+ * There, the governor only sets the net update frequency of the pawns; that doesn't buy a listen server any frame
+ * time, thus it only follows the number of clients.
+ *
+ * Besides, it caps the bandwidth of every client connection at `ConnectionBytesPerSecond`: right after login (cf.
+ * `AMyGameModeBase::PostLogin`) and at the start of every frame, such that neither `netspeed` nor a network emulation
+ * profile (cf. `UMyNetQualitySubsystem::ApplyNetSpeed`) lifts it.
+ *
+ * Configured in "DefaultGame.ini", `mp.Governor` logs the current state.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMyServerGovernor : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// average game thread work per frame (without idle time) in seconds, over the last evaluation interval
+	float GetAverageFrameTime() const
+	{
+		return AverageFrameTime;
+	}
+
+	// frame time relative to the budget of `MaxTickRate`; 1 means fully loaded
+	float GetLoad() const
+	{
+		return Load;
+	}
+
+	void LogState() const;
+
+	// `NetSpeed` limited to `ConnectionBytesPerSecond`
+	int32 ClampNetSpeed(int32 NetSpeed) const
+	{
+		return ConnectionBytesPerSecond > 0 ? FMath::Min(NetSpeed, ConnectionBytesPerSecond) : NetSpeed;
+	}
+
+	void ClampConnection(UNetConnection* Connection) const;
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	UPROPERTY(Config)
+	float EvaluationInterval = 1.f;
+
+	UPROPERTY(Config)
+	int32 MinTickRate = 20;
+
+	UPROPERTY(Config)
+	int32 MaxTickRate = 60;
+
+	UPROPERTY(Config)
+	float MinNetUpdateFrequency = 5.f;
+
+	UPROPERTY(Config)
+	float MaxNetUpdateFrequency = 30.f;
+
+	// number of clients at which the maximum rates are reached
+	UPROPERTY(Config)
+	int32 FullConnectionCount = 16;
+
+	// above this load, the rates go down
+	UPROPERTY(Config)
+	float HighLoad = .9f;
+
+	// below this load, the rates may go up again
+	UPROPERTY(Config)
+	float LowLoad = .6f;
+
+	// how much a single evaluation moves the rates when over- or underloaded, relative to the range min..max
+	UPROPERTY(Config)
+	float Step = .1f;
+
+	// Upper limit of each client connection's net speed in bytes per second, 0 for none. Once a connection used up
+	// its budget in a frame, the net driver defers the remaining actors to later frames, lowest priority first.
+	UPROPERTY(Config)
+	int32 ConnectionBytesPerSecond = 0;
+
+private:
+	void HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void Evaluate();
+	void Apply() const;
+
+	// net tick rate for `Level`, 0 where it isn't governed (not a dedicated server)
+	int32 GetTickRate() const;
+
+	FDelegateHandle WorldTickStartHandle;
+	FTimerHandle EvaluationTimer;
+
+	float AccumulatedFrameTime = 0.f;
+	int32 AccumulatedFrames = 0;
+
+	float AverageFrameTime = 0.f;
+	float Load = 0.f;
+	int32 NumConnections = 0;
+
+	// 0: minimum rates, 1: maximum rates
+	float Level = 0.f;
+};
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MySessionAdvertiser.generated.h"
+
+/**
+ * Keeps the advertised settings of the hosted session up to date: player count (`SETTING_NUMPLAYERS`), server load
+ * (`SETTING_LOAD`, cf. `UMyServerGovernor::GetLoad`) and the current level (`SETTING_MAPNAME`), such that searching
+ * clients can rank sessions, cf. `UMyGISubsystem::JoinSession`.
+ *
+ * Every `UpdateSession` is a request to the online service, thus updates are coalesced: joins and leaves (and load
+ * changes of at least `LoadChangeThreshold`) only mark the advertisement dirty; it gets published at most every
+ * `MinUpdateInterval` seconds. A burst of joins results in a single update.
+ *
+ * `mp.SessionAdvert` logs what has been published and how many requests got coalesced.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMySessionAdvertiser : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// something that is advertised changed, publish with the next update
+	void MarkDirty();
+
+	void LogState() const;
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	UPROPERTY(Config)
+	float MinUpdateInterval = 5.f;
+
+	// how often we check whether an update is due
+	UPROPERTY(Config)
+	float CheckInterval = 1.f;
+
+	UPROPERTY(Config)
+	float LoadChangeThreshold = .1f;
+
+private:
+	void Check();
+
+	FTimerHandle CheckTimer;
+
+	bool bDirty = false;
+	double LastUpdateTime = -1.;
+
+	// as published last
+	int32 PublishedPlayers = 0;
+	float PublishedLoad = 0.f;
+	FString PublishedMap;
+
+	int32 Requests = 0;
+	int32 Updates = 0;
+};
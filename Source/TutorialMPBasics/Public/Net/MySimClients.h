@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MySimClients.generated.h"
+
+class UMySimConnection;
+
+/**
+ * Load tests without client processes: simulated clients inside the host process, hundreds or thousands of them on one
+ * machine.
+ *
+ * Every simulated client is a `UMySimConnection` in the net driver of the host plus a player controller spawned for
+ * it the way a real join does (`UWorld::SpawnPlayActor`, i.e. `Login` and `PostLogin` of `AMyGameModeBase`), thus it
+ * gets a pawn, and the host replicates everything to it like to a real client. The replicated data gets serialized
+ * and counted, but not decoded: there is no client world, nothing gets rendered. Every `InputInterval` seconds (with
+ * some jitter), each simulated client presses left or right, which takes the same path on the host as
+ * `ServerRPC_HandleAction` does.
+ *
+ * Only compiled in with `WITH_SIM_CLIENTS` (all but shipping builds, cf. "TutorialMPBasics.Build.cs"). In the host
+ * console: `mp.SimClients.Add [count]`, `mp.SimClients.Remove [count]`, and `mp.SimClients` for the statistics since
+ * the last call (clients, bytes sent to them, frame times of the host). `-SimClients=<count>` on the command line of a
+ * dedicated server adds them right away; they get added `SpawnsPerFrame` per frame.
+ */
+UCLASS(Config=Game)
+class TUTORIALMPBASICS_API UMySimClients : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// host only
+	void AddClients(int32 Count);
+	// removes the most recent ones, all for `Count` < 0
+	void RemoveClients(int32 Count);
+
+	int32 GetNumClients() const
+	{
+		return Clients.Num();
+	}
+
+	// resets the measurement
+	void LogStats();
+
+protected:
+	// event handlers
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	UPROPERTY(Config)
+	int32 SpawnsPerFrame = 16;
+
+	UPROPERTY(Config)
+	float InputInterval = 0.5f;
+
+private:
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	bool SpawnClient();
+
+	struct FSimClient
+	{
+		TWeakObjectPtr<UMySimConnection> Connection;
+		float NextInput = 0.f;
+		// bytes sent to this client up to the last `LogStats`
+		int64 LoggedBytes = 0;
+	};
+	TArray<FSimClient> Clients;
+
+	int32 PendingSpawns = 0;
+	int32 NextClientId = 0;
+
+	// since the last `LogStats`
+	double StatsStartTime = 0.;
+	int32 StatsFrames = 0;
+	float StatsMaxFrame = 0.f;
+	int64 StatsInputs = 0;
+
+	FDelegateHandle WorldPostActorTickHandle;
+};
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetConnection.h"
+#include "MySimConnection.generated.h"
+
+/**
+ * A client connection without a client, cf. `UMySimClients`: it lives in the net driver of the host like the
+ * connection of a real client, thus the host replicates to it the same way, but there is no socket and no process on
+ * the other end. Packets end in `LowLevelSend`, which only counts them; everything sent counts as acknowledged right
+ * away (internal ack, the same mechanism replays use), thus nothing ever gets resent and the connection never times
+ * out.
+ */
+UCLASS(Transient)
+class TUTORIALMPBASICS_API UMySimConnection : public UNetConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitConnection(UNetDriver* InDriver, EConnectionState InState, const FURL& InURL, int32 InConnectionSpeed = 0, int32 InMaxPacket = 0) override;
+	virtual void LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits) override;
+	virtual FString LowLevelGetRemoteAddress(bool bAppendPort = false) override;
+	virtual FString LowLevelDescribe() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	// what a real client would have received so far
+	int64 GetBytesReceived() const
+	{
+		return BytesReceived;
+	}
+
+	int64 GetPacketsReceived() const
+	{
+		return PacketsReceived;
+	}
+
+private:
+	int64 BytesReceived = 0;
+	int64 PacketsReceived = 0;
+};
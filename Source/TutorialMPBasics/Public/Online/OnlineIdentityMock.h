@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineIdentityInterface.h"
+
+class FOnlineSubsystemMock;
+
+/**
+ * identity interface of `FOnlineSubsystemMock`: every login with any credentials succeeds (unless the failure
+ * injection says otherwise) and yields a unique net id "mock-<n>"
+ */
+class TUTORIALMPBASICS_API FOnlineIdentityMock : public IOnlineIdentity
+{
+public:
+	explicit FOnlineIdentityMock(FOnlineSubsystemMock* InSubsystem);
+
+	// IOnlineIdentity
+	virtual bool Login(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials) override;
+	virtual bool Logout(int32 LocalUserNum) override;
+	virtual bool AutoLogin(int32 LocalUserNum) override;
+	virtual TSharedPtr<FUserOnlineAccount> GetUserAccount(const FUniqueNetId& UserId) const override;
+	virtual TArray<TSharedPtr<FUserOnlineAccount>> GetAllUserAccounts() const override;
+	virtual FUniqueNetIdPtr GetUniquePlayerId(int32 LocalUserNum) const override;
+	virtual FUniqueNetIdPtr CreateUniquePlayerId(uint8* Bytes, int32 Size) override;
+	virtual FUniqueNetIdPtr CreateUniquePlayerId(const FString& Str) override;
+	virtual ELoginStatus::Type GetLoginStatus(int32 LocalUserNum) const override;
+	virtual ELoginStatus::Type GetLoginStatus(const FUniqueNetId& UserId) const override;
+	virtual FString GetPlayerNickname(int32 LocalUserNum) const override;
+	virtual FString GetPlayerNickname(const FUniqueNetId& UserId) const override;
+	virtual FString GetAuthToken(int32 LocalUserNum) const override;
+	virtual void RevokeAuthToken(const FUniqueNetId& LocalUserId, const FOnRevokeAuthTokenCompleteDelegate& Delegate) override;
+	virtual void GetUserPrivilege(const FUniqueNetId& LocalUserId, EUserPrivileges::Type Privilege, const FOnGetUserPrivilegeCompleteDelegate& Delegate) override;
+	virtual FPlatformUserId GetPlatformUserIdFromUniqueNetId(const FUniqueNetId& UniqueNetId) const override;
+	virtual FString GetAuthType() const override;
+
+private:
+	FOnlineSubsystemMock* Subsystem;
+
+	// unique net ids of the logged-in local users, by local user num
+	TMap<int32, FUniqueNetIdRef> LoggedInUsers;
+	int32 NextUserId = 0;
+};
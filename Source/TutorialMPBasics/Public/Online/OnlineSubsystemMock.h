@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSubsystemImpl.h"
+
+#define MOCK_SUBSYSTEM FName(TEXT("MOCK"))
+
+class FOnlineIdentityMock;
+class FOnlineSessionMock;
+
+/**
+ * An in-process stand-in for the EOS online subsystem, for testing and benchmarking the online code path
+ * (login, presence sessions, presence search) without the live service.
+ *
+ * Only identity and sessions are implemented. Every call completes asynchronously after a configurable latency and
+ * fails with a configurable probability; session searches return a configurable number of fake sessions on top of the
+ * sessions created in this process. Configured in section `[OnlineSubsystemMock]` of "DefaultEngine.ini".
+ *
+ * `-MockOnline` on the command line makes `UMyGISubsystem` use this subsystem instead of EOS.
+ */
+class TUTORIALMPBASICS_API FOnlineSubsystemMock : public FOnlineSubsystemImpl
+{
+public:
+	FOnlineSubsystemMock(FName InInstanceName);
+
+	// IOnlineSubsystem
+	virtual IOnlineSessionPtr GetSessionInterface() const override;
+	virtual IOnlineFriendsPtr GetFriendsInterface() const override { return nullptr; }
+	virtual IOnlinePartyPtr GetPartyInterface() const override { return nullptr; }
+	virtual IOnlineGroupsPtr GetGroupsInterface() const override { return nullptr; }
+	virtual IOnlineSharedCloudPtr GetSharedCloudInterface() const override { return nullptr; }
+	virtual IOnlineUserCloudPtr GetUserCloudInterface() const override { return nullptr; }
+	virtual IOnlineEntitlementsPtr GetEntitlementsInterface() const override { return nullptr; }
+	virtual IOnlineLeaderboardsPtr GetLeaderboardsInterface() const override { return nullptr; }
+	virtual IOnlineVoicePtr GetVoiceInterface() const override { return nullptr; }
+	virtual IOnlineExternalUIPtr GetExternalUIInterface() const override { return nullptr; }
+	virtual IOnlineTimePtr GetTimeInterface() const override { return nullptr; }
+	virtual IOnlineIdentityPtr GetIdentityInterface() const override;
+	virtual IOnlineTitleFilePtr GetTitleFileInterface() const override { return nullptr; }
+	virtual IOnlineStoreV2Ptr GetStoreV2Interface() const override { return nullptr; }
+	virtual IOnlinePurchasePtr GetPurchaseInterface() const override { return nullptr; }
+	virtual IOnlineEventsPtr GetEventsInterface() const override { return nullptr; }
+	virtual IOnlineAchievementsPtr GetAchievementsInterface() const override { return nullptr; }
+	virtual IOnlineSharingPtr GetSharingInterface() const override { return nullptr; }
+	virtual IOnlineUserPtr GetUserInterface() const override { return nullptr; }
+	virtual IOnlineMessagePtr GetMessageInterface() const override { return nullptr; }
+	virtual IOnlinePresencePtr GetPresenceInterface() const override { return nullptr; }
+	virtual IOnlineChatPtr GetChatInterface() const override { return nullptr; }
+	virtual IOnlineStatsPtr GetStatsInterface() const override { return nullptr; }
+	virtual IOnlineTurnBasedPtr GetTurnBasedInterface() const override { return nullptr; }
+	virtual IOnlineTournamentPtr GetTournamentInterface() const override { return nullptr; }
+
+	virtual bool Init() override;
+	virtual bool Shutdown() override;
+	virtual FString GetAppId() const override;
+	virtual FText GetOnlineServiceName() const override;
+
+	// FTSTickerObjectBase
+	virtual bool Tick(float DeltaTime) override;
+
+	// Run `Task` after the configured latency (plus jitter); `Task` gets `true` if the call is supposed to fail.
+	// Everything runs on the game thread, from `Tick`.
+	void RunDelayed(TFunction<void(bool bFail)> Task);
+
+	int32 GetFakeSessionCount() const
+	{
+		return FakeSessionCount;
+	}
+
+	const FString& GetFakeSessionAddress() const
+	{
+		return FakeSessionAddress;
+	}
+
+private:
+	TSharedPtr<FOnlineIdentityMock, ESPMode::ThreadSafe> IdentityInterface;
+	TSharedPtr<FOnlineSessionMock, ESPMode::ThreadSafe> SessionInterface;
+
+	struct FPendingTask
+	{
+		double DueTime;
+		bool bFail;
+		TFunction<void(bool)> Task;
+	};
+	TArray<FPendingTask> PendingTasks;
+
+	// configuration
+	float LatencyMs = 100.f;
+	float JitterMs = 50.f;
+	float FailureRate = 0.f;
+	int32 FakeSessionCount = 0;
+	FString FakeSessionAddress = TEXT("127.0.0.1:7777");
+};
+
+// registers `FOnlineSubsystemMock` as online subsystem "MOCK"
+class FOnlineFactoryMock : public IOnlineFactory
+{
+public:
+	virtual IOnlineSubsystemPtr CreateSubsystem(FName InstanceName) override;
+};
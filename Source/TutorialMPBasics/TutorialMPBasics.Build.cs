@@ -10,10 +10,30 @@ public class TutorialMPBasics : ModuleRules
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "OnlineSubsystemUtils", "OnlineSubsystem" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "OnlineSubsystemUtils", "OnlineSubsystem", "NetCore" });
 
-		// Uncomment if you are using Slate UI
-		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+		// Compile in support for Iris (UE 5.1 and later) if the engine build has it enabled (`bUseIris`)
+		System.Reflection.MethodInfo SetupIris = typeof(ModuleRules).GetMethod
+			( "SetupIrisSupport"
+			, System.Reflection.BindingFlags.Instance | System.Reflection.BindingFlags.Public | System.Reflection.BindingFlags.NonPublic
+			);
+		if (SetupIris != null)
+		{
+			System.Reflection.ParameterInfo[] Parameters = SetupIris.GetParameters();
+			object[] Arguments = new object[Parameters.Length];
+			Arguments[0] = Target;
+			for (int i = 1; i < Parameters.Length; i++)
+			{
+				Arguments[i] = Parameters[i].DefaultValue;
+			}
+			SetupIris.Invoke(this, Arguments);
+		}
+
+		// In-process simulated clients for load tests, cf. `UMySimClients`; never in shipped builds
+		PublicDefinitions.Add("WITH_SIM_CLIENTS=" + (Target.Configuration == UnrealTargetConfiguration.Shipping ? "0" : "1"));
+
+		// Slate for the loading screen, which the movie player renders on its own thread during map loads
+		PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore", "MoviePlayer" });
 		
 		// Uncomment if you are using online features
 		// PrivateDependencyModuleNames.Add("OnlineSubsystem");
@@ -1,6 +1,87 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "TutorialMPBasics.h"
+#include "Engine/World.h"
 #include "Modules/ModuleManager.h"
+#include "OnlineSubsystemModule.h"
+#include "Diagnostics/MyEventLog.h"
+#include "Online/OnlineSubsystemMock.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, TutorialMPBasics, "TutorialMPBasics" );
+class FTutorialMPBasicsModule : public FDefaultGameModuleImpl
+{
+	virtual void StartupModule() override
+	{
+		// the mock online subsystem is always available, `-MockOnline` decides whether it's used
+		FModuleManager::LoadModuleChecked<FOnlineSubsystemModule>(TEXT("OnlineSubsystem"))
+			.RegisterPlatformService(MOCK_SUBSYSTEM, &MockFactory);
+
+		ApplyReplicationBackend();
+
+		// an editor session needs no event log until it plays: opened with the first game world (PIE) then
+		if(GIsEditor)
+		{
+			PostWorldInitializationHandle = FWorldDelegates::OnPostWorldInitialization.AddLambda([] (UWorld* World, const UWorld::InitializationValues)
+			{
+				if(World->IsGameWorld())
+				{
+					FMyEventLog::Get().Start();
+				}
+			});
+		}
+		else
+		{
+			FMyEventLog::Get().Start();
+		}
+	}
+
+	// Launch switch for the replication backend: `-ReplicationBackend=Iris` or `-ReplicationBackend=Classic`.
+	// Both backends use the same `GetLifetimeReplicatedProps` and RPC declarations, thus nothing else changes.
+	// This has to happen before the first net driver gets created, i.e. way before any `ServerTravel`.
+	// A backend this engine doesn't have quits the game with exit code 1, a benchmark mustn't silently measure the
+	// other one; `-ReplicationBackendCheck` quits right away, with 0 if the backend is available (cf.
+	// "bench_replication.bat").
+	static void ApplyReplicationBackend()
+	{
+		FString Backend;
+		if(!FParse::Value(FCommandLine::Get(), TEXT("ReplicationBackend="), Backend))
+		{
+			return;
+		}
+		const bool bUseIris = Backend.Equals(TEXT("Iris"), ESearchCase::IgnoreCase);
+		IConsoleVariable* CVarUseIris = IConsoleManager::Get().FindConsoleVariable(TEXT("net.Iris.UseIrisReplication"));
+		if(CVarUseIris)
+		{
+			CVarUseIris->Set(bUseIris ? 1 : 0, ECVF_SetByCommandline);
+		}
+		else if(bUseIris)
+		{
+			// UE 5.0 doesn't come with Iris, and later versions only with Iris compiled in (not with an installed engine)
+			UE_LOG(LogNet, Error, TEXT("ReplicationBackend=Iris: this engine has no Iris support, quitting"))
+			GLog->Flush();
+			FPlatformMisc::RequestExitWithStatus(true, 1);
+			return;
+		}
+		UE_LOG(LogNet, Display, TEXT("Replication backend: %s"), bUseIris ? TEXT("Iris") : TEXT("Classic"))
+		if(FParse::Param(FCommandLine::Get(), TEXT("ReplicationBackendCheck")))
+		{
+			GLog->Flush();
+			FPlatformMisc::RequestExitWithStatus(true, 0);
+		}
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FWorldDelegates::OnPostWorldInitialization.Remove(PostWorldInitializationHandle);
+		FMyEventLog::Get().Stop();
+
+		if(FOnlineSubsystemModule* OSSModule = FModuleManager::GetModulePtr<FOnlineSubsystemModule>(TEXT("OnlineSubsystem")))
+		{
+			OSSModule->UnregisterPlatformService(MOCK_SUBSYSTEM);
+		}
+	}
+
+	FOnlineFactoryMock MockFactory;
+	FDelegateHandle PostWorldInitializationHandle;
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FTutorialMPBasicsModule, TutorialMPBasics, "TutorialMPBasics" );
@@ -3,4 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
+// All counters and timers of this module live in this stat group; type `stat TutorialMPBasics` into the console
+// to see them
+DECLARE_STATS_GROUP(TEXT("TutorialMPBasics"), STATGROUP_TutorialMPBasics, STATCAT_Advanced);
@@ -0,0 +1,41 @@
+@echo off
+rem Replication benchmark: classic replication vs. Iris at 16, 64 and 128 bot clients.
+rem Iris needs an engine with Iris compiled in (not UE 5.0, not an installed engine); without it, its runs are skipped.
+rem For every run, the host logs a single "NetBench: ..." line with replication CPU time and bandwidth, cf.
+rem "Source/TutorialMPBasics/Public/Net/MyNetStatsSubsystem.h"; the logs end up in Saved\Logs\bench_*.log
+
+set UE="F:\ue\UE_5.0\Engine\Binaries\Win64\UnrealEditor.exe"
+set PROJECT="F:\ue\projects\TutorialMPBasics\TutorialMPBasics.uproject"
+rem seconds of measurement per run, after all bots had time to connect
+set DURATION=60
+
+for %%b in (Classic Iris) do (
+	call :backend %%b
+)
+findstr /c:"NetBench:" Saved\Logs\bench_*.log
+goto :eof
+
+:backend
+rem %1: replication backend; the game quits with exit code 1 if this engine doesn't have it, e.g. Iris on UE 5.0
+start "" /wait %UE% %PROJECT% -game -nullrhi -nosound -unattended -ReplicationBackend=%1 -ReplicationBackendCheck -abslog="%~dp0Saved\Logs\check_%1.log"
+if errorlevel 1 (
+	echo Replication backend %1 isn't available in this engine, skipping its runs
+	goto :eof
+)
+for %%n in (16 64 128) do (
+	call :run %1 %%n
+)
+goto :eof
+
+:run
+rem %1: replication backend, %2: number of bot clients
+start "" %UE% %PROJECT% /Game/SomeLevel?listen -game -nullrhi -nosound -unattended -ReplicationBackend=%1 -NetBench=%DURATION% -abslog="%~dp0Saved\Logs\bench_%1_%2.log"
+timeout /t 10 /nobreak > nul
+for /l %%i in (1,1,%2) do (
+	start "" /min %UE% %PROJECT% 127.0.0.1 -game -nullrhi -nosound -unattended -ReplicationBackend=%1 -BotInput -nolog
+)
+rem the host quits by itself, the bots lose their connection and quit after the net driver times out
+timeout /t %DURATION% /nobreak > nul
+timeout /t 30 /nobreak > nul
+taskkill /im UnrealEditor.exe /f > nul 2>&1
+goto :eof
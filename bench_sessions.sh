@@ -0,0 +1,24 @@
+#!/bin/sh
+# Session lifecycle benchmark, headless, on loopback with the NULL online subsystem, cf.
+# "Source/TutorialMPBasics/Public/Modes/MySessionBenchmark.h"
+# usage: UE_ROOT=/path/to/UnrealEngine ./bench_sessions.sh [cycles]
+# exits with 1 when a stage exceeds its latency budget or session delegates leak
+
+UE_ROOT="${UE_ROOT:-$HOME/UnrealEngine}"
+EDITOR="$UE_ROOT/Engine/Binaries/Linux/UnrealEditor"
+PROJECT="$(cd "$(dirname "$0")" && pwd)/TutorialMPBasics.uproject"
+CYCLES="${1:-20}"
+ARGS="-game -nullrhi -nosound -unattended -SessionBenchCycles=$CYCLES"
+
+mkdir -p Saved/Logs
+"$EDITOR" "$PROJECT" $ARGS -SessionBench=host -abslog="$PWD/Saved/Logs/bench_sessions_host.log" &
+HOST=$!
+sleep 10
+"$EDITOR" "$PROJECT" $ARGS -SessionBench=join -abslog="$PWD/Saved/Logs/bench_sessions_join.log"
+JOIN_STATUS=$?
+# the host does its cycles on its own schedule, give it time to finish
+wait $HOST
+HOST_STATUS=$?
+
+grep -h "SessionBench:" Saved/Logs/bench_sessions_host.log Saved/Logs/bench_sessions_join.log
+[ $HOST_STATUS -eq 0 ] && [ $JOIN_STATUS -eq 0 ]
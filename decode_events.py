@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# Turns a binary event log ("Saved/Logs/Events-*.mpev", cf. FMyEventLog) into text.
+#
+#   python3 decode_events.py Saved/Logs/Events-2024.01.01-12.00.00.mpev > events.txt
+
+import struct
+import sys
+
+MAGIC = 0x5645504D
+BLOCK_EVENT, BLOCK_NAME, BLOCK_DROPPED = 1, 2, 3
+ARG_INT, ARG_FLOAT, ARG_BOOL, ARG_NAME = 0, 1, 2, 3
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def read(self, fmt):
+        values = struct.unpack_from('<' + fmt, self.data, self.pos)
+        self.pos += struct.calcsize('<' + fmt)
+        return values if len(values) > 1 else values[0]
+
+    def string(self):
+        length = self.read('H')
+        value = self.data[self.pos:self.pos + length].decode('utf-8')
+        self.pos += length
+        return value
+
+    def done(self):
+        return self.pos >= len(self.data)
+
+
+def name(names, index, number):
+    text = names.get(index, '<name %d>' % index)
+    # FName numbers are stored off by one, 0 means "no number"
+    return text if number == 0 else '%s_%d' % (text, number - 1)
+
+
+def decode(path, out):
+    with open(path, 'rb') as f:
+        r = Reader(f.read())
+    magic, version = r.read('II')
+    if magic != MAGIC or version != 1:
+        sys.exit('%s: not an event log (version 1)' % path)
+    seconds_per_cycle, start_cycles = r.read('dQ')
+    events = [(r.string(), r.string()) for _ in range(r.read('H'))]
+    names = {}
+
+    # the file may end in the middle of a block if the process got killed
+    try:
+        while not r.done():
+            block = r.read('B')
+            if block == BLOCK_NAME:
+                index = r.read('I')
+                names[index] = r.string()
+            elif block == BLOCK_DROPPED:
+                thread, count = r.read('II')
+                out.write('[thread %d] %d events dropped\n' % (thread, count))
+            elif block == BLOCK_EVENT:
+                event, thread, cycles, object_id, object_name, object_number, num_args = r.read('HIQIIIB')
+                args = []
+                for _ in range(num_args):
+                    arg_type, value = r.read('BQ')
+                    if arg_type == ARG_INT:
+                        args.append(str(struct.unpack('<q', struct.pack('<Q', value))[0]))
+                    elif arg_type == ARG_FLOAT:
+                        args.append('%g' % struct.unpack('<d', struct.pack('<Q', value))[0])
+                    elif arg_type == ARG_BOOL:
+                        args.append('true' if value else 'false')
+                    else:
+                        args.append(name(names, value & 0xFFFFFFFF, value >> 32))
+                event_name, text = events[event] if event < len(events) else ('Unknown%d' % event, '')
+                for i, arg in enumerate(args):
+                    text = text.replace('{%d}' % i, arg)
+                obj = name(names, object_name, object_number) if object_name else '-'
+                out.write('[%12.6f] [thread %d] %s#%d: %s: %s\n' % (
+                    (cycles - start_cycles) * seconds_per_cycle, thread, obj, object_id, event_name, text))
+            else:
+                sys.exit('%s: corrupt block at offset %d' % (path, r.pos - 1))
+    except struct.error:
+        out.write('(truncated)\n')
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        sys.exit('usage: decode_events.py <file.mpev>')
+    decode(sys.argv[1], sys.stdout)
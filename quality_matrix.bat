@@ -0,0 +1,12 @@
+@echo off
+rem Netcode quality matrix: a loopback host plus a client that runs through all network emulation profiles, cf.
+rem "Source/TutorialMPBasics/Public/Net/MyNetQualitySubsystem.h"; the table ends up in Saved\Logs\quality_matrix.log
+
+set UE="F:\ue\UE_5.0\Engine\Binaries\Win64\UnrealEditor.exe"
+set PROJECT="F:\ue\projects\TutorialMPBasics\TutorialMPBasics.uproject"
+
+start "" %UE% %PROJECT% /Game/SomeLevel?listen -game -nullrhi -nosound -unattended -log
+timeout /t 10 /nobreak > nul
+%UE% %PROJECT% 127.0.0.1 -game -nullrhi -nosound -unattended -NetQualityMatrix -abslog="%~dp0Saved\Logs\quality_matrix.log"
+findstr /c:"NetQuality:" Saved\Logs\quality_matrix.log
+taskkill /im UnrealEditor.exe /f > nul 2>&1